@@ -0,0 +1,114 @@
+#include "Camera.hpp"
+#include "RayPacket.hpp"
+#include "Scene.hpp"
+#include "SceneGenerator.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// Build time, refit time and primary ray throughput of the BVH for scenes
+// of random spheres, compared with testing every sphere.
+//
+//     ray_tracer_bvh_bench [sphere count...]
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t imageSize{256};
+constexpr std::size_t packetLanes{8};
+// sphere tests spent on the unaccelerated reference at each scene size
+constexpr double bruteForceBudget{1e8};
+
+auto seconds(Clock::time_point start) -> double
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// rays per second tracing the first `rays` pixels one ray at a time
+auto traceRays(const Scene& scene, const Camera& camera, std::size_t rays, std::size_t& hits) -> double
+{
+    const auto start = Clock::now();
+    for (std::size_t pixel{0}; pixel < rays; ++pixel) {
+        if (scene.hit(camera.rayForPixel(pixel % imageSize, pixel/imageSize))) {
+            ++hits;
+        }
+    }
+    return static_cast<double>(rays)/seconds(start);
+}
+
+auto tracePackets(const Scene& scene, const Camera& camera, std::size_t& hits) -> double
+{
+    const auto start = Clock::now();
+    for (std::size_t y{0}; y < imageSize; ++y) {
+        for (std::size_t x{0}; x < imageSize; x += packetLanes) {
+            RayPacket<packetLanes> packet;
+            for (std::size_t lane{0}; lane < packetLanes; ++lane) {
+                packet.setRay(lane, camera.rayForPixel(x + lane, y));
+            }
+            PacketHits<packetLanes> packetHits;
+            scene.intersect(packet, packetHits);
+            for (std::size_t lane{0}; lane < packetLanes; ++lane) {
+                if (packetHits.hit(lane)) {
+                    ++hits;
+                }
+            }
+        }
+    }
+    return static_cast<double>(imageSize*imageSize)/seconds(start);
+}
+
+auto benchmark(std::size_t count) -> void
+{
+    const SceneSpec spec{count};
+    auto scene = generateScene(spec);
+    const auto camera = generatedSceneCamera(spec, imageSize, imageSize);
+    const auto pixels = imageSize*imageSize;
+
+    const auto bruteRays = std::min(pixels, std::max<std::size_t>(
+        packetLanes, static_cast<std::size_t>(bruteForceBudget/static_cast<double>(count))));
+    std::size_t bruteHits{0};
+    const auto bruteRate = traceRays(scene, camera, bruteRays, bruteHits);
+
+    auto start = Clock::now();
+    scene.build();
+    const auto buildTime = seconds(start);
+    start = Clock::now();
+    scene.refit();
+    const auto refitTime = seconds(start);
+
+    std::size_t rayHits{0};
+    const auto rayRate = traceRays(scene, camera, pixels, rayHits);
+    std::size_t packetHits{0};
+    const auto packetRate = tracePackets(scene, camera, packetHits);
+
+    std::printf("%9zu %10.1f %10.1f %6zu %14.0f %14.0f %14.0f %8zu\n",
+                count, buildTime*1e3, refitTime*1e3, scene.bvh().depth(),
+                bruteRate, rayRate, packetRate, rayHits);
+    if (rayHits != packetHits) {
+        std::fprintf(stderr, "packet hits %zu differ from single ray hits %zu\n", packetHits, rayHits);
+        std::exit(EXIT_FAILURE);
+    }
+}
+}
+
+auto main(int argc, char* argv[]) -> int
+{
+    std::vector<std::size_t> counts{1000, 100000, 1000000};
+    if (argc > 1) {
+        counts.clear();
+        for (auto i = 1; i < argc; ++i) {
+            counts.push_back(std::stoul(argv[i]));
+        }
+    }
+    std::printf("%zux%zu primary rays, packets of %zu\n", imageSize, imageSize, packetLanes);
+    std::printf("%9s %10s %10s %6s %14s %14s %14s %8s\n",
+                "spheres", "build ms", "refit ms", "depth", "brute rays/s", "bvh rays/s", "packet rays/s", "hits");
+    for (const auto count: counts) {
+        benchmark(count);
+    }
+    return 0;
+}
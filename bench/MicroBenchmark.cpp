@@ -0,0 +1,452 @@
+#include "Canvas.hpp"
+#include "Color.hpp"
+#include "MathConsts.hpp"
+#include "Matrix.hpp"
+#include "PerfEvents.hpp"
+#include "Point.hpp"
+#include "Ray.hpp"
+#include "Sphere.hpp"
+#include "ThreadPool.hpp"
+#include "Transformations.hpp"
+#include "Vector.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <random>
+#include <vector>
+
+// Throughput of the math and canvas kernels, built on Google Benchmark:
+//
+//     ray_tracer_bench --benchmark_out=current.json --benchmark_out_format=json
+//     bench/compare.py bench/baseline.json current.json
+//
+// or the bench_compare target, which does both with five repetitions. The
+// baseline only means something on the machine it was recorded on; write
+// a new one there with the same flags as bench_compare.
+//
+// Every benchmark cycles through a table of random operands, so neither
+// the operands nor the results are compile time constants. Built with
+// PERF_COUNTERS, each also reports the hardware events of its loop per
+// iteration where the counters can be opened.
+namespace
+{
+constexpr std::size_t operandCount{256};
+
+template<typename T, typename Make>
+auto operands(Make make) -> std::array<T, operandCount>
+{
+    std::mt19937 generator{42};
+    std::uniform_real_distribution<float> value{-2.f, 2.f};
+    std::array<T, operandCount> result{};
+    for (auto& operand: result) {
+        operand = make([&]() { return value(generator); });
+    }
+    return result;
+}
+
+auto vectors() -> std::array<Vec4, operandCount>
+{
+    return operands<Vec4>([](auto next) { return Vec4{next(), next(), next(), 0.f}; });
+}
+
+auto points() -> std::array<Point4, operandCount>
+{
+    return operands<Point4>([](auto next) { return Point4{next(), next(), next(), 1.f}; });
+}
+
+auto colors() -> std::array<Color, operandCount>
+{
+    return operands<Color>([](auto next) { return Color{next(), next(), next()}; });
+}
+
+// invertible: random rotations and scales around a random translation
+auto matrices() -> std::array<Mat4, operandCount>
+{
+    return operands<Mat4>([](auto next) {
+        return TransformationStacker().rotate_x(next())
+                                      .rotate_y(next())
+                                      .scale(next() + 3.f, next() + 3.f, next() + 3.f)
+                                      .translate(next(), next(), next())
+                                      .getMatrix();
+    });
+}
+
+// constructed right before the timed loop, reports when it has ended
+#ifdef RAY_TRACER_PERF_COUNTERS
+class HardwareCounters
+{
+    public:
+        explicit HardwareCounters(benchmark::State& state) noexcept:
+            _state{state},
+            _start{_group.read()}
+        {}
+
+        ~HardwareCounters()
+        {
+            if (!_group.available()) {
+                _state.SetLabel("no hardware counters");
+                return;
+            }
+            constexpr std::array<const char*, hardwareEventCount> names{
+                "cycles", "instructions", "cache misses", "branch misses"};
+            const auto end = _group.read();
+            for (std::size_t i{0}; i < hardwareEventCount; ++i) {
+                if (_group.available(static_cast<HardwareEvent>(i))) {
+                    _state.counters[names[i]] = benchmark::Counter(static_cast<double>(end[i] - _start[i]),
+                                                                   benchmark::Counter::kAvgIterations);
+                }
+            }
+            const auto cycles = end[0] - _start[0];
+            if (cycles > 0) {
+                _state.counters["IPC"] = static_cast<double>(end[1] - _start[1])/static_cast<double>(cycles);
+            }
+        }
+
+        HardwareCounters(const HardwareCounters&) = delete;
+        auto operator=(const HardwareCounters&) -> HardwareCounters& = delete;
+
+    private:
+        benchmark::State& _state;
+        PerfEventGroup _group;
+        EventCounts _start;
+};
+#else
+class HardwareCounters
+{
+    public:
+        explicit HardwareCounters(benchmark::State&) noexcept {}
+};
+#endif
+
+auto next(std::size_t& index) noexcept -> std::size_t
+{
+    index = (index + 1) % operandCount;
+    return index;
+}
+
+auto vectorAdd(benchmark::State& state) -> void
+{
+    const auto lhs = vectors();
+    const auto rhs = vectors();
+    std::size_t i{0};
+    const HardwareCounters events{state};
+    for (auto _: state) {
+        next(i);
+        benchmark::DoNotOptimize(lhs[i] + rhs[operandCount - 1 - i]);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(vectorAdd);
+
+auto vectorDot(benchmark::State& state) -> void
+{
+    const auto lhs = vectors();
+    const auto rhs = vectors();
+    std::size_t i{0};
+    const HardwareCounters events{state};
+    for (auto _: state) {
+        next(i);
+        benchmark::DoNotOptimize(dotProduct(lhs[i], rhs[operandCount - 1 - i]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(vectorDot);
+
+auto vectorCross(benchmark::State& state) -> void
+{
+    const auto lhs = operands<Vec3>([](auto next) { return Vec3{next(), next(), next()}; });
+    const auto rhs = operands<Vec3>([](auto next) { return Vec3{next(), next(), next()}; });
+    std::size_t i{0};
+    const HardwareCounters events{state};
+    for (auto _: state) {
+        next(i);
+        auto product = lhs[i];
+        benchmark::DoNotOptimize(product.cross(rhs[operandCount - 1 - i]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(vectorCross);
+
+auto vectorNormalize(benchmark::State& state) -> void
+{
+    const auto values = vectors();
+    std::size_t i{0};
+    const HardwareCounters events{state};
+    for (auto _: state) {
+        benchmark::DoNotOptimize(normalize(values[next(i)]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(vectorNormalize);
+
+auto pointDifference(benchmark::State& state) -> void
+{
+    const auto lhs = points();
+    const auto rhs = points();
+    std::size_t i{0};
+    const HardwareCounters events{state};
+    for (auto _: state) {
+        next(i);
+        benchmark::DoNotOptimize(lhs[i] - rhs[operandCount - 1 - i]);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(pointDifference);
+
+auto pointPlusVector(benchmark::State& state) -> void
+{
+    const auto lhs = points();
+    const auto rhs = vectors();
+    std::size_t i{0};
+    const HardwareCounters events{state};
+    for (auto _: state) {
+        next(i);
+        benchmark::DoNotOptimize(lhs[i] + rhs[i]);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(pointPlusVector);
+
+// multi-term expressions, where temporaries of every operator would show
+auto vectorMultiTerm(benchmark::State& state) -> void
+{
+    const auto lhs = vectors();
+    const auto rhs = vectors();
+    const auto values = colors();
+    std::size_t i{0};
+    const HardwareCounters events{state};
+    for (auto _: state) {
+        next(i);
+        benchmark::DoNotOptimize(lhs[i] + rhs[operandCount - 1 - i]*values[i].r() - rhs[i]);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(vectorMultiTerm);
+
+auto rayPosition(benchmark::State& state) -> void
+{
+    const auto origins = points();
+    const auto directions = vectors();
+    const auto times = colors();
+    std::vector<Ray> rays;
+    for (std::size_t r{0}; r < operandCount; ++r) {
+        rays.emplace_back(origins[r], directions[r]);
+    }
+    std::size_t i{0};
+    const HardwareCounters events{state};
+    for (auto _: state) {
+        next(i);
+        benchmark::DoNotOptimize(rays[i].position(times[i].g()));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(rayPosition);
+
+auto matrixMultiply(benchmark::State& state) -> void
+{
+    const auto values = matrices();
+    std::size_t i{0};
+    const HardwareCounters events{state};
+    for (auto _: state) {
+        next(i);
+        benchmark::DoNotOptimize(values[i]*values[operandCount - 1 - i]);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(matrixMultiply);
+
+auto matrixTimesPoint(benchmark::State& state) -> void
+{
+    const auto values = matrices();
+    const auto targets = points();
+    std::size_t i{0};
+    const HardwareCounters events{state};
+    for (auto _: state) {
+        next(i);
+        benchmark::DoNotOptimize(values[i]*targets[i]);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(matrixTimesPoint);
+
+auto matrixInverse(benchmark::State& state) -> void
+{
+    const auto values = matrices();
+    std::size_t i{0};
+    const HardwareCounters events{state};
+    for (auto _: state) {
+        benchmark::DoNotOptimize(inverse(values[next(i)]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(matrixInverse);
+
+auto matrixAffineInverse(benchmark::State& state) -> void
+{
+    const auto values = matrices();
+    std::size_t i{0};
+    const HardwareCounters events{state};
+    for (auto _: state) {
+        benchmark::DoNotOptimize(affineInverse(values[next(i)]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(matrixAffineInverse);
+
+auto matrixDeterminant(benchmark::State& state) -> void
+{
+    const auto values = matrices();
+    std::size_t i{0};
+    const HardwareCounters events{state};
+    for (auto _: state) {
+        benchmark::DoNotOptimize(determinant(values[next(i)]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(matrixDeterminant);
+
+// the chain every scene object is placed with, including the inverse
+auto transformationChain(benchmark::State& state) -> void
+{
+    const auto values = vectors();
+    std::size_t i{0};
+    const HardwareCounters events{state};
+    for (auto _: state) {
+        const auto& v = values[next(i)];
+        benchmark::DoNotOptimize(TransformationStacker().scale(v[0] + 3.f, v[1] + 3.f, v[2] + 3.f)
+                                                        .rotate_y(v[0])
+                                                        .rotate_x(v[1])
+                                                        .translate(v[2], v[1], v[0])
+                                                        .getTransform());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(transformationChain);
+
+// rays from a ring around a stretched sphere towards points near it,
+// about half of them hitting
+auto sphereIntersect(benchmark::State& state) -> void
+{
+    auto sphere = Sphere();
+    sphere.setTransform(TransformationStacker().scale(1.5f, 1.f, 1.f).translate(0.f, 0.5f, 0.f).getTransform());
+    const auto targets = vectors();
+    std::vector<Ray> rays;
+    std::size_t hits{0};
+    for (std::size_t r{0}; r < operandCount; ++r) {
+        const auto angle = 2.f*mathConst::pi*static_cast<float>(r)/operandCount;
+        const Point4 origin{5.f*std::cos(angle), 0.f, 5.f*std::sin(angle), 1.f};
+        const Point4 target{0.6f*targets[r][0], 0.6f*targets[r][1], 0.6f*targets[r][2], 1.f};
+        rays.emplace_back(origin, normalize(target - origin));
+        hits += sphere.intersect(rays.back(), 0).empty() ? 0u : 1u;
+    }
+    std::size_t i{0};
+    const HardwareCounters events{state};
+    for (auto _: state) {
+        benchmark::DoNotOptimize(sphere.intersect(rays[next(i)], 0));
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["hit ratio"] = static_cast<double>(hits)/operandCount;
+}
+BENCHMARK(sphereIntersect);
+
+auto colorAdd(benchmark::State& state) -> void
+{
+    const auto lhs = colors();
+    const auto rhs = colors();
+    std::size_t i{0};
+    const HardwareCounters events{state};
+    for (auto _: state) {
+        next(i);
+        benchmark::DoNotOptimize(lhs[i] + rhs[operandCount - 1 - i]);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(colorAdd);
+
+auto colorMultiply(benchmark::State& state) -> void
+{
+    auto lhs = colors();
+    const auto rhs = colors();
+    std::size_t i{0};
+    const HardwareCounters events{state};
+    for (auto _: state) {
+        next(i);
+        benchmark::DoNotOptimize(lhs[i]*rhs[operandCount - 1 - i]);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(colorMultiply);
+
+auto colorScale(benchmark::State& state) -> void
+{
+    const auto values = colors();
+    std::size_t i{0};
+    const HardwareCounters events{state};
+    for (auto _: state) {
+        next(i);
+        benchmark::DoNotOptimize(values[i]*values[operandCount - 1 - i].r());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(colorScale);
+
+auto colorBlend(benchmark::State& state) -> void
+{
+    const auto lhs = colors();
+    const auto rhs = colors();
+    std::size_t i{0};
+    const HardwareCounters events{state};
+    for (auto _: state) {
+        next(i);
+        const auto weight = lhs[operandCount - 1 - i].b();
+        benchmark::DoNotOptimize(lhs[i]*weight + rhs[i]*(1.f - weight));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(colorBlend);
+
+// a 640x360 gradient written as each PPM flavour, rows encoded by a
+// pool of state.range(1) threads or on the calling thread for 0; timed
+// by the wall clock, as the pool threads do not count as CPU time here
+auto canvasSave(benchmark::State& state) -> void
+{
+    constexpr std::size_t width{640};
+    constexpr std::size_t height{360};
+    Canvas canvas{width, height};
+    for (std::size_t y{0}; y < height; ++y) {
+        for (std::size_t x{0}; x < width; ++x) {
+            canvas(x, y) = Color{static_cast<float>(x)/width, static_cast<float>(y)/height, 0.5f};
+        }
+    }
+    const auto format = static_cast<PpmFormat>(state.range(0));
+    const auto threads = static_cast<std::size_t>(state.range(1));
+    const auto filePath = std::filesystem::temp_directory_path()/"ray_tracer_bench.ppm";
+    ThreadPool pool{std::max<std::size_t>(threads, 1)};
+    const HardwareCounters events{state};
+    for (auto _: state) {
+        if (threads == 0) {
+            canvas.saveToFile(filePath, format);
+        } else {
+            canvas.saveToFile(filePath, format, pool);
+        }
+    }
+    state.SetItemsProcessed(state.iterations()*static_cast<std::int64_t>(width*height));
+    state.SetBytesProcessed(state.iterations()*static_cast<std::int64_t>(std::filesystem::file_size(filePath)));
+    std::filesystem::remove(filePath);
+}
+BENCHMARK(canvasSave)
+    ->ArgNames({"format", "threads"})
+    ->ArgsProduct({{static_cast<std::int64_t>(PpmFormat::plain),
+                    static_cast<std::int64_t>(PpmFormat::binary8),
+                    static_cast<std::int64_t>(PpmFormat::binary16)},
+                   {0, 4}})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+}
+
+BENCHMARK_MAIN();
@@ -0,0 +1,289 @@
+#include "AllocationTracking.hpp"
+#include "Camera.hpp"
+#include "Canvas.hpp"
+#include "Color.hpp"
+#include "Instrumentation.hpp"
+#include "Renderer.hpp"
+#include "Scene.hpp"
+#include "SceneGenerator.hpp"
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+
+#include <sys/resource.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Whole frames rendered through Renderer into a Canvas, for every
+// combination of sphere count, resolution and thread count: wall time,
+// primary rays per second and peak resident memory.
+//
+//     ray_tracer_scaling_bench [--spheres 10,1000,...] [--resolutions 320x180,...]
+//                              [--threads 1,4,...] [--seed n] [--packets] [--json file]
+//                              [--trace file]
+//
+// Scenes come from generateScene(), so the same seed renders the same
+// frames everywhere. Peak memory is reset before each frame where Linux
+// allows it (/proc/self/clear_refs) and is the peak of the whole run
+// otherwise, which the report says. Built with INSTRUMENTATION, the JSON
+// report adds the counters and phase times of every run, and built with
+// ALLOCATION_TRACKING its heap allocations. --trace records the whole
+// benchmark as a Chrome trace, one span per tile and thread.
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+// frames are repeated until they took this long, so small ones are timed
+// over more than one frame
+constexpr double minRenderSeconds{0.2};
+constexpr std::size_t packetLanes{8};
+
+struct Resolution
+{
+    std::size_t width;
+    std::size_t height;
+};
+
+struct Options
+{
+    std::vector<std::size_t> sphereCounts{10, 1000, 100000, 1000000};
+    std::vector<Resolution> resolutions{{320, 180}, {1280, 720}};
+    std::vector<std::size_t> threadCounts{1, ThreadPool::defaultThreadCount()};
+    std::uint32_t seed{42};
+    bool packets{false};
+    std::string jsonPath;
+    std::string tracePath;
+};
+
+struct Run
+{
+    std::size_t spheres;
+    Resolution resolution;
+    std::size_t threads;
+    double generateSeconds;
+    double buildSeconds;
+    std::size_t frames;
+    double frameSeconds;
+    std::size_t peakRss;
+    // of all frames of the run, with the INSTRUMENTATION option
+    instrument::Report report;
+    // with ALLOCATION_TRACKING
+    allocation::Counts allocations;
+};
+
+auto seconds(Clock::time_point start) -> double
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+auto resetPeakRss() -> bool
+{
+    std::ofstream clearRefs{"/proc/self/clear_refs"};
+    clearRefs << "5";
+    return static_cast<bool>(clearRefs.flush());
+}
+
+// bytes, from VmHWM when available
+auto peakRss() -> std::size_t
+{
+    std::ifstream status{"/proc/self/status"};
+    for (std::string line; std::getline(status, line);) {
+        if (line.rfind("VmHWM:", 0) == 0) {
+            return std::stoul(line.substr(6))*1024;
+        }
+    }
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<std::size_t>(usage.ru_maxrss)*1024;
+}
+
+[[noreturn]] auto usage() -> void
+{
+    std::fprintf(stderr, "usage: ray_tracer_scaling_bench [--spheres n,...] [--resolutions wxh,...] "
+                         "[--threads n,...] [--seed n] [--packets] [--json file] [--trace file]\n");
+    std::exit(EXIT_FAILURE);
+}
+
+auto split(const std::string& list) -> std::vector<std::string>
+{
+    std::vector<std::string> items;
+    std::istringstream stream{list};
+    for (std::string item; std::getline(stream, item, ',');) {
+        items.push_back(item);
+    }
+    return items;
+}
+
+auto parse(int argc, char* argv[]) -> Options
+{
+    Options options;
+    for (auto i = 1; i < argc; ++i) {
+        const std::string option{argv[i]};
+        if (option == "--packets") {
+            options.packets = true;
+            continue;
+        }
+        if (i + 1 == argc) {
+            usage();
+        }
+        const std::string value{argv[++i]};
+        try {
+            if (option == "--spheres") {
+                options.sphereCounts.clear();
+                for (const auto& item: split(value)) {
+                    options.sphereCounts.push_back(std::stoul(item));
+                }
+            } else if (option == "--resolutions") {
+                options.resolutions.clear();
+                for (const auto& item: split(value)) {
+                    const auto separator = item.find('x');
+                    if (separator == std::string::npos) {
+                        usage();
+                    }
+                    options.resolutions.push_back({std::stoul(item.substr(0, separator)),
+                                                   std::stoul(item.substr(separator + 1))});
+                }
+            } else if (option == "--threads") {
+                options.threadCounts.clear();
+                for (const auto& item: split(value)) {
+                    options.threadCounts.push_back(std::stoul(item));
+                }
+            } else if (option == "--seed") {
+                options.seed = static_cast<std::uint32_t>(std::stoul(value));
+            } else if (option == "--json") {
+                options.jsonPath = value;
+            } else if (option == "--trace") {
+                options.tracePath = value;
+            } else {
+                usage();
+            }
+        } catch (const std::logic_error&) {
+            usage();
+        }
+    }
+    if (options.threadCounts.size() == 2 && options.threadCounts[0] == options.threadCounts[1]) {
+        options.threadCounts.pop_back();
+    }
+    return options;
+}
+
+auto renderFrame(const Renderer& renderer, Canvas& canvas, ThreadPool& pool, bool packets) -> void
+{
+    if (packets) {
+        renderer.renderPackets<packetLanes>(canvas, pool);
+    } else {
+        renderer.render(canvas, pool);
+    }
+}
+
+auto print(const Run& run) -> void
+{
+    const auto pixels = static_cast<double>(run.resolution.width*run.resolution.height);
+    std::printf("%9zu %11s %7zu %11.1f %9.1f %10.2f %12.0f %11.1f\n",
+                run.spheres,
+                (std::to_string(run.resolution.width) + "x" + std::to_string(run.resolution.height)).c_str(),
+                run.threads,
+                run.generateSeconds*1e3,
+                run.buildSeconds*1e3,
+                run.frameSeconds*1e3,
+                pixels/run.frameSeconds,
+                static_cast<double>(run.peakRss)/(1024.0*1024.0));
+    std::fflush(stdout);
+}
+
+auto writeJson(const Options& options, const std::vector<Run>& runs, bool peakReset) -> void
+{
+    std::ofstream file{options.jsonPath};
+    file << "{\n  \"context\": {\"seed\": " << options.seed
+         << ", \"packets\": " << (options.packets ? "true" : "false")
+         << ", \"hardware_threads\": " << ThreadPool::defaultThreadCount()
+         << ", \"peak_rss_per_run\": " << (peakReset ? "true" : "false") << "},\n  \"runs\": [";
+    for (std::size_t i{0}; i < runs.size(); ++i) {
+        const auto& run = runs[i];
+        const auto pixels = static_cast<double>(run.resolution.width*run.resolution.height);
+        file << (i == 0 ? "\n" : ",\n")
+             << "    {\"spheres\": " << run.spheres
+             << ", \"width\": " << run.resolution.width
+             << ", \"height\": " << run.resolution.height
+             << ", \"threads\": " << run.threads
+             << ", \"generate_seconds\": " << run.generateSeconds
+             << ", \"build_seconds\": " << run.buildSeconds
+             << ", \"frames\": " << run.frames
+             << ", \"frame_seconds\": " << run.frameSeconds
+             << ", \"rays_per_second\": " << pixels/run.frameSeconds
+             << ", \"peak_rss_bytes\": " << run.peakRss;
+        if (instrument::enabled()) {
+            file << ", \"instrumentation\": " << instrument::toJson(run.report);
+        }
+        if (allocation::tracking()) {
+            file << ", \"allocations\": " << run.allocations.allocations
+                 << ", \"allocated_bytes\": " << run.allocations.bytes;
+        }
+        file << "}";
+    }
+    file << "\n  ]\n}\n";
+    if (!file) {
+        std::fprintf(stderr, "cannot write %s\n", options.jsonPath.c_str());
+        std::exit(EXIT_FAILURE);
+    }
+}
+}
+
+auto main(int argc, char* argv[]) -> int
+{
+    const auto options = parse(argc, argv);
+    const auto peakReset = resetPeakRss();
+    std::printf("seed %u, %s, peak memory %s\n",
+                options.seed,
+                options.packets ? "packets of 8 rays" : "single rays",
+                peakReset ? "per frame" : "of the whole run");
+    std::printf("%9s %11s %7s %11s %9s %10s %12s %11s\n",
+                "spheres", "resolution", "threads", "generate ms", "build ms", "frame ms", "rays/s", "peak MiB");
+    std::vector<Run> runs;
+    if (!options.tracePath.empty()) {
+        trace::start();
+    }
+    for (const auto count: options.sphereCounts) {
+        const SceneSpec spec{count, options.seed};
+        auto start = Clock::now();
+        auto scene = generateScene(spec);
+        const auto generateSeconds = seconds(start);
+        start = Clock::now();
+        scene.build();
+        const auto buildSeconds = seconds(start);
+        instrument::collect();
+        allocation::collect();
+        for (const auto& resolution: options.resolutions) {
+            const auto camera = generatedSceneCamera(spec, resolution.width, resolution.height);
+            const Renderer renderer{scene, camera};
+            for (const auto threads: options.threadCounts) {
+                ThreadPool pool{threads};
+                resetPeakRss();
+                Canvas canvas{resolution.width, resolution.height};
+                std::size_t frames{0};
+                start = Clock::now();
+                do {
+                    renderFrame(renderer, canvas, pool, options.packets);
+                    ++frames;
+                } while (seconds(start) < minRenderSeconds);
+                const auto frameSeconds = seconds(start)/static_cast<double>(frames);
+                runs.push_back({count, resolution, threads, generateSeconds, buildSeconds,
+                                frames, frameSeconds, peakRss(), instrument::collect(),
+                                allocation::collect().total()});
+                print(runs.back());
+            }
+        }
+    }
+    if (!options.tracePath.empty()) {
+        trace::stop(options.tracePath);
+    }
+    if (!options.jsonPath.empty()) {
+        writeJson(options, runs, peakReset);
+    }
+    return 0;
+}
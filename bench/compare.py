@@ -0,0 +1,84 @@
+#!/usr/bin/env python3
+"""Compares two Google Benchmark JSON reports of ray_tracer_bench.
+
+    compare.py baseline.json current.json [--threshold 0.1] [--metric real_time]
+
+Benchmarks are matched by name. With repetitions the median aggregate is
+compared, otherwise the mean of the runs. Exits with status 1 when any
+benchmark is slower than the baseline by more than the threshold, so it
+can gate a build; benchmarks missing from either report are listed but
+do not fail. The default threshold assumes both reports come from the
+same quiet machine; on shared or frequency scaling hosts the nanosecond
+benchmarks drift by more than that between runs.
+"""
+
+import argparse
+import json
+import sys
+
+NANOSECONDS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def load(path, metric):
+    """Time per iteration in nanoseconds of every benchmark in a report."""
+    with open(path) as report:
+        benchmarks = json.load(report)["benchmarks"]
+    medians = {}
+    runs = {}
+    for benchmark in benchmarks:
+        name = benchmark.get("run_name", benchmark["name"])
+        time = benchmark[metric]*NANOSECONDS[benchmark.get("time_unit", "ns")]
+        if benchmark.get("run_type") == "aggregate":
+            if benchmark.get("aggregate_name") == "median":
+                medians[name] = time
+        else:
+            runs.setdefault(name, []).append(time)
+    times = {name: sum(values)/len(values) for name, values in runs.items()}
+    times.update(medians)
+    return times
+
+
+def format_time(nanoseconds):
+    for unit in ("s", "ms", "us"):
+        if nanoseconds >= NANOSECONDS[unit]:
+            return "%.3g %s" % (nanoseconds/NANOSECONDS[unit], unit)
+    return "%.3g ns" % nanoseconds
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=0.1,
+                        help="relative slowdown that counts as a regression (default 0.1)")
+    parser.add_argument("--metric", choices=("real_time", "cpu_time"), default="real_time")
+    arguments = parser.parse_args()
+
+    baseline = load(arguments.baseline, arguments.metric)
+    current = load(arguments.current, arguments.metric)
+    width = max(len(name) for name in list(baseline) + list(current) + ["benchmark"])
+    print("%-*s %12s %12s %9s" % (width, "benchmark", "baseline", "current", "change"))
+    regressions = []
+    for name in sorted(set(baseline) | set(current)):
+        if name not in current:
+            print("%-*s %12s %12s %9s" % (width, name, format_time(baseline[name]), "-", "missing"))
+            continue
+        if name not in baseline:
+            print("%-*s %12s %12s %9s" % (width, name, "-", format_time(current[name]), "new"))
+            continue
+        change = current[name]/baseline[name] - 1.0
+        regressed = change > arguments.threshold
+        if regressed:
+            regressions.append(name)
+        print("%-*s %12s %12s %+8.1f%%%s" % (width, name, format_time(baseline[name]),
+                                            format_time(current[name]), 100.0*change,
+                                            "  REGRESSION" if regressed else ""))
+    if regressions:
+        print("%d of %d benchmarks slower than the baseline by more than %.0f%%"
+              % (len(regressions), len(baseline), 100.0*arguments.threshold))
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,186 @@
+#pragma once
+
+#include "Matrix.hpp"
+#include "Point.hpp"
+#include "Simd.hpp"
+#include "Utilities.hpp"
+#include "Vector.hpp"
+
+#include <array>
+#include <initializer_list>
+#include <stdexcept>
+#include <ostream>
+
+// Affine transformation kept as the top three rows of a 4x4 matrix, the
+// bottom row is implicitly 0 0 0 1. Rows are 16-byte aligned so applying
+// it to a Point4/Vec4 is three 4-lane dot products.
+class Affine3
+{
+    public:
+        static constexpr std::size_t rows{3};
+        static constexpr std::size_t columns{4};
+
+        constexpr Affine3() noexcept = default;
+
+        constexpr Affine3(std::initializer_list<float> list):
+            _matrix{}
+        {
+            if (list.size() > rows*columns) {
+                throw std::runtime_error("Too many elements in initializer list");
+            }
+            std::size_t index{0};
+            for (const auto value: list) {
+                _matrix[index++] = value;
+            }
+        }
+
+        constexpr explicit Affine3(const Mat4& mat):
+            _matrix{}
+        {
+            for (std::size_t row{0}; row < rows; ++row) {
+                for (std::size_t column{0}; column < columns; ++column) {
+                    (*this)(row, column) = mat(row, column);
+                }
+            }
+        }
+
+        constexpr auto operator*=(const Affine3& rhs) -> Affine3&
+        {
+            Affine3 tmp{};
+            for (std::size_t row{0}; row < rows; ++row) {
+                for (std::size_t column{0}; column < columns; ++column) {
+                    tmp(row, column) = column == 3 ? (*this)(row, 3) : 0.f;
+                    for (std::size_t k{0}; k < 3; ++k) {
+                        tmp(row, column) += (*this)(row, k)*rhs(k, column);
+                    }
+                }
+            }
+            _matrix = tmp._matrix;
+            return *this;
+        }
+
+        constexpr auto at(std::size_t row, std::size_t column) const -> float
+        {
+            if (row >= rows || column >= columns) {
+                throw std::runtime_error("out of bounds");
+            }
+            return _matrix[coordToIndex(row, column)];
+        }
+
+        constexpr auto at(std::size_t row, std::size_t column) -> float&
+        {
+            if (row >= rows || column >= columns) {
+                throw std::runtime_error("out of bounds");
+            }
+            return _matrix[coordToIndex(row, column)];
+        }
+
+        constexpr auto operator()(std::size_t row, std::size_t column) const noexcept -> float
+        {
+            RAY_TRACER_ASSERT_INDEX(row < rows && column < columns);
+            return _matrix[coordToIndex(row, column)];
+        }
+
+        constexpr auto operator()(std::size_t row, std::size_t column) noexcept -> float&
+        {
+            RAY_TRACER_ASSERT_INDEX(row < rows && column < columns);
+            return _matrix[coordToIndex(row, column)];
+        }
+
+        auto data() const noexcept -> const float*
+        {
+            return _matrix.data();
+        }
+
+        constexpr auto toMatrix() const -> Mat4
+        {
+            auto mat = matrix::identity4;
+            for (std::size_t row{0}; row < rows; ++row) {
+                for (std::size_t column{0}; column < columns; ++column) {
+                    mat(row, column) = (*this)(row, column);
+                }
+            }
+            return mat;
+        }
+
+    private:
+        constexpr auto coordToIndex(std::size_t row, std::size_t column) const noexcept -> std::size_t
+        {
+            return columns*row + column;
+        }
+
+        alignas(16) std::array<float, rows*columns> _matrix{1.f, 0.f, 0.f, 0.f,
+                                                             0.f, 1.f, 0.f, 0.f,
+                                                             0.f, 0.f, 1.f, 0.f};
+};
+
+inline auto operator==(const Affine3& lhs, const Affine3& rhs)
+{
+    for (std::size_t row{0}; row < Affine3::rows; ++row) {
+        for (std::size_t column{0}; column < Affine3::columns; ++column) {
+            if (!relativelyEqual(lhs(row, column), rhs(row, column))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+inline auto operator!=(const Affine3& lhs, const Affine3& rhs)
+{
+    return !(lhs == rhs);
+}
+
+constexpr auto operator*(Affine3 lhs, const Affine3& rhs)
+{
+    lhs *= rhs;
+    return lhs;
+}
+
+inline auto operator*(const Affine3& lhs, const Point4& rhs)
+{
+    const auto p = simd::load(rhs.data());
+    return Point4{simd::dot(simd::load(lhs.data()), p),
+                  simd::dot(simd::load(lhs.data() + 4), p),
+                  simd::dot(simd::load(lhs.data() + 8), p),
+                  rhs[3]};
+}
+
+inline auto operator*(const Affine3& lhs, const Vec4& rhs)
+{
+    const auto v = simd::load(rhs.data());
+    return Vec4{simd::dot(simd::load(lhs.data()), v),
+                simd::dot(simd::load(lhs.data() + 4), v),
+                simd::dot(simd::load(lhs.data() + 8), v),
+                rhs[3]};
+}
+
+constexpr auto inverse(const Affine3& mat)
+{
+    Affine3 inv;
+    invertAffineRows(mat, inv);
+    return inv;
+}
+
+// for rotations and translations only: the 3x3 part is orthonormal, so its
+// inverse is its transpose
+constexpr auto rigidInverse(const Affine3& mat)
+{
+    Affine3 inv;
+    for (std::size_t row{0}; row < 3; ++row) {
+        for (std::size_t column{0}; column < 3; ++column) {
+            inv(row, column) = mat(column, row);
+        }
+    }
+    for (std::size_t row{0}; row < 3; ++row) {
+        inv(row, 3) = -(inv(row, 0)*mat(0, 3) +
+                        inv(row, 1)*mat(1, 3) +
+                        inv(row, 2)*mat(2, 3));
+    }
+    return inv;
+}
+
+inline auto operator<<(std::ostream& os, const Affine3& mat) -> std::ostream&
+{
+    return os << mat.toMatrix();
+}
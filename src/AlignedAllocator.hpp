@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <new>
+
+// Allocator for containers whose storage has to start on an `alignment`
+// byte boundary, e.g. a cache line, beyond what alignof(T) asks for.
+template<typename T, std::size_t alignment>
+struct AlignedAllocator
+{
+    static_assert(alignment >= alignof(T), "alignment weaker than the type's own");
+
+    using value_type = T;
+
+    template<typename U>
+    struct rebind
+    {
+        using other = AlignedAllocator<U, alignment>;
+    };
+
+    AlignedAllocator() noexcept = default;
+
+    template<typename U>
+    AlignedAllocator(const AlignedAllocator<U, alignment>&) noexcept
+    {}
+
+    auto allocate(std::size_t count) -> T*
+    {
+        return static_cast<T*>(::operator new(count*sizeof(T), std::align_val_t{alignment}));
+    }
+
+    auto deallocate(T* pointer, std::size_t) noexcept -> void
+    {
+        ::operator delete(pointer, std::align_val_t{alignment});
+    }
+};
+
+template<typename T, typename U, std::size_t alignment>
+auto operator==(const AlignedAllocator<T, alignment>&, const AlignedAllocator<U, alignment>&) noexcept -> bool
+{
+    return true;
+}
+
+template<typename T, typename U, std::size_t alignment>
+auto operator!=(const AlignedAllocator<T, alignment>&, const AlignedAllocator<U, alignment>&) noexcept -> bool
+{
+    return false;
+}
@@ -0,0 +1,134 @@
+#include "AllocationTracking.hpp"
+
+// Replacements of the global allocation functions, compiled only with
+// RAY_TRACER_TRACK_ALLOCATIONS; the unit tests always build this file
+// with it. Every form forwards to malloc, aligned_alloc and free.
+#ifdef RAY_TRACER_TRACK_ALLOCATIONS
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+const bool enabled = (allocation::detail::enableTracking(), true);
+
+auto allocate(std::size_t size) noexcept -> void*
+{
+    allocation::detail::recordAllocation(size);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+auto allocate(std::size_t size, std::align_val_t alignment) noexcept -> void*
+{
+    allocation::detail::recordAllocation(size);
+    const auto align = static_cast<std::size_t>(alignment);
+    // aligned_alloc wants a non zero multiple of the alignment
+    return std::aligned_alloc(align, size == 0 ? align : (size + align - 1)/align*align);
+}
+
+auto release(void* memory) noexcept -> void
+{
+    if (memory != nullptr) {
+        allocation::detail::recordDeallocation();
+        std::free(memory);
+    }
+}
+
+auto orThrow(void* memory) -> void*
+{
+    if (memory == nullptr) {
+        throw std::bad_alloc{};
+    }
+    return memory;
+}
+}
+
+auto operator new(std::size_t size) -> void*
+{
+    return orThrow(allocate(size));
+}
+
+auto operator new[](std::size_t size) -> void*
+{
+    return orThrow(allocate(size));
+}
+
+auto operator new(std::size_t size, std::align_val_t alignment) -> void*
+{
+    return orThrow(allocate(size, alignment));
+}
+
+auto operator new[](std::size_t size, std::align_val_t alignment) -> void*
+{
+    return orThrow(allocate(size, alignment));
+}
+
+auto operator new(std::size_t size, const std::nothrow_t&) noexcept -> void*
+{
+    return allocate(size);
+}
+
+auto operator new[](std::size_t size, const std::nothrow_t&) noexcept -> void*
+{
+    return allocate(size);
+}
+
+auto operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept -> void*
+{
+    return allocate(size, alignment);
+}
+
+auto operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept -> void*
+{
+    return allocate(size, alignment);
+}
+
+auto operator delete(void* memory) noexcept -> void
+{
+    release(memory);
+}
+
+auto operator delete[](void* memory) noexcept -> void
+{
+    release(memory);
+}
+
+auto operator delete(void* memory, std::size_t) noexcept -> void
+{
+    release(memory);
+}
+
+auto operator delete[](void* memory, std::size_t) noexcept -> void
+{
+    release(memory);
+}
+
+auto operator delete(void* memory, std::align_val_t) noexcept -> void
+{
+    release(memory);
+}
+
+auto operator delete[](void* memory, std::align_val_t) noexcept -> void
+{
+    release(memory);
+}
+
+auto operator delete(void* memory, std::size_t, std::align_val_t) noexcept -> void
+{
+    release(memory);
+}
+
+auto operator delete[](void* memory, std::size_t, std::align_val_t) noexcept -> void
+{
+    release(memory);
+}
+
+auto operator delete(void* memory, const std::nothrow_t&) noexcept -> void
+{
+    release(memory);
+}
+
+auto operator delete[](void* memory, const std::nothrow_t&) noexcept -> void
+{
+    release(memory);
+}
+#endif
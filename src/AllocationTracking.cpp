@@ -0,0 +1,172 @@
+#include "AllocationTracking.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+
+// Counts live in a fixed table of per thread slots, as the operators they
+// are called from cannot allocate a record. Threads beyond the table share
+// its last slot, which stays correct as every count is an atomic add.
+namespace allocation
+{
+namespace
+{
+constexpr std::size_t maxThreads{1024};
+constexpr auto slotCount = instrument::phaseCount + 1;
+
+struct AtomicCounts
+{
+    std::atomic<std::uint64_t> allocations;
+    std::atomic<std::uint64_t> bytes;
+    std::atomic<std::uint64_t> deallocations;
+};
+
+struct ThreadSlot
+{
+    std::array<AtomicCounts, slotCount> phases;
+    // everything this thread did, never cleared, for the scopes
+    AtomicCounts lifetime;
+};
+
+std::array<ThreadSlot, maxThreads> slots{};
+std::atomic<std::size_t> usedSlots{0};
+std::atomic<bool> interposed{false};
+
+thread_local ThreadSlot* slot{nullptr};
+thread_local bool forbidden{false};
+
+constexpr std::array<const char*, slotCount> phaseNames{
+    "render", "ray generation", "intersection", "shading", "bvh build", "save", "outside phases"};
+
+auto localSlot() noexcept -> ThreadSlot&
+{
+    if (slot == nullptr) {
+        const auto index = usedSlots.fetch_add(1, std::memory_order_relaxed);
+        slot = &slots[std::min(index, maxThreads - 1)];
+    }
+    return *slot;
+}
+
+auto load(const AtomicCounts& counts) noexcept -> Counts
+{
+    return Counts{counts.allocations.load(std::memory_order_relaxed),
+                  counts.bytes.load(std::memory_order_relaxed),
+                  counts.deallocations.load(std::memory_order_relaxed)};
+}
+
+auto add(Counts& sum, const Counts& counts) noexcept -> void
+{
+    sum.allocations += counts.allocations;
+    sum.bytes += counts.bytes;
+    sum.deallocations += counts.deallocations;
+}
+}
+
+auto Report::phase(instrument::Phase phase) const noexcept -> const Counts&
+{
+    return phases[static_cast<std::size_t>(phase)];
+}
+
+auto Report::outside() const noexcept -> const Counts&
+{
+    return phases[instrument::phaseCount];
+}
+
+auto Report::total() const noexcept -> Counts
+{
+    Counts sum;
+    for (const auto& counts: phases) {
+        add(sum, counts);
+    }
+    return sum;
+}
+
+auto tracking() noexcept -> bool
+{
+    return interposed.load(std::memory_order_relaxed);
+}
+
+auto collect() -> Report
+{
+    Report report;
+    const auto used = std::min(usedSlots.load(std::memory_order_relaxed), maxThreads);
+    for (std::size_t thread{0}; thread < used; ++thread) {
+        for (std::size_t phase{0}; phase < slotCount; ++phase) {
+            auto& counts = slots[thread].phases[phase];
+            add(report.phases[phase], Counts{counts.allocations.exchange(0, std::memory_order_relaxed),
+                                             counts.bytes.exchange(0, std::memory_order_relaxed),
+                                             counts.deallocations.exchange(0, std::memory_order_relaxed)});
+        }
+    }
+    return report;
+}
+
+auto summary(const Report& report) -> std::string
+{
+    std::string text;
+    char line[128];
+    std::snprintf(line, sizeof(line), "%-16s %12s %14s %12s\n", "allocations", "count", "bytes", "frees");
+    text += line;
+    for (std::size_t phase{0}; phase < slotCount; ++phase) {
+        const auto& counts = report.phases[phase];
+        std::snprintf(line, sizeof(line), "%-16s %12llu %14llu %12llu\n", phaseNames[phase],
+                      static_cast<unsigned long long>(counts.allocations),
+                      static_cast<unsigned long long>(counts.bytes),
+                      static_cast<unsigned long long>(counts.deallocations));
+        text += line;
+    }
+    return text;
+}
+
+AllocationScope::AllocationScope() noexcept:
+    _start{load(localSlot().lifetime)}
+{}
+
+auto AllocationScope::counts() const noexcept -> Counts
+{
+    const auto now = load(localSlot().lifetime);
+    return Counts{now.allocations - _start.allocations,
+                  now.bytes - _start.bytes,
+                  now.deallocations - _start.deallocations};
+}
+
+NoAllocationScope::NoAllocationScope() noexcept:
+    _outer{forbidden}
+{
+    forbidden = true;
+}
+
+NoAllocationScope::~NoAllocationScope()
+{
+    forbidden = _outer;
+}
+
+auto detail::enableTracking() noexcept -> void
+{
+    interposed.store(true, std::memory_order_relaxed);
+}
+
+auto detail::recordAllocation(std::size_t bytes) noexcept -> void
+{
+    if (forbidden) {
+        forbidden = false;
+        std::fprintf(stderr, "allocation of %zu bytes in a NoAllocationScope\n", bytes);
+        std::abort();
+    }
+    auto& local = localSlot();
+    const auto phase = std::min(instrument::detail::currentPhase, instrument::phaseCount);
+    for (auto* counts: {&local.phases[phase], &local.lifetime}) {
+        counts->allocations.fetch_add(1, std::memory_order_relaxed);
+        counts->bytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+}
+
+auto detail::recordDeallocation() noexcept -> void
+{
+    auto& local = localSlot();
+    const auto phase = std::min(instrument::detail::currentPhase, instrument::phaseCount);
+    local.phases[phase].deallocations.fetch_add(1, std::memory_order_relaxed);
+    local.lifetime.deallocations.fetch_add(1, std::memory_order_relaxed);
+}
+}
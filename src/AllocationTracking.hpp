@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Instrumentation.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Heap allocations counted by replacements of the global operator new and
+// delete. They are linked in by the ALLOCATION_TRACKING option, which
+// defines RAY_TRACER_TRACK_ALLOCATIONS and also attributes allocations to
+// the instrument::Phase the allocating thread is in, and always into the
+// unit tests, so tests can require code to be allocation free. Without
+// them tracking() is false and every count stays zero.
+namespace allocation
+{
+struct Counts
+{
+    std::uint64_t allocations{0};
+    std::uint64_t bytes{0};
+    std::uint64_t deallocations{0};
+};
+
+struct Report
+{
+    // one per instrument::Phase, then allocations outside of any
+    std::array<Counts, instrument::phaseCount + 1> phases{};
+
+    auto phase(instrument::Phase phase) const noexcept -> const Counts&;
+    auto outside() const noexcept -> const Counts&;
+    auto total() const noexcept -> Counts;
+};
+
+// whether operator new and delete are replaced in this program
+auto tracking() noexcept -> bool;
+// Merges and clears the counts of all threads. Slots of threads are never
+// reused: past 1024 threads in one program, the rest share one slot.
+auto collect() -> Report;
+auto summary(const Report& report) -> std::string;
+
+// Counts the allocations of the constructing thread while it lives.
+class AllocationScope
+{
+    public:
+        AllocationScope() noexcept;
+
+        auto counts() const noexcept -> Counts;
+
+    private:
+        Counts _start;
+};
+
+// Aborts with the size of the allocation when the constructing thread
+// allocates while it lives; for finding the culprit in a debugger.
+class NoAllocationScope
+{
+    public:
+        NoAllocationScope() noexcept;
+        ~NoAllocationScope();
+        NoAllocationScope(const NoAllocationScope&) = delete;
+        auto operator=(const NoAllocationScope&) -> NoAllocationScope& = delete;
+
+    private:
+        bool _outer;
+};
+
+namespace detail
+{
+// hooks of the replaced operators, which must not allocate themselves
+auto enableTracking() noexcept -> void;
+auto recordAllocation(std::size_t bytes) noexcept -> void;
+auto recordDeallocation() noexcept -> void;
+}
+}
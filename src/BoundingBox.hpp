@@ -0,0 +1,55 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+
+// Axis aligned box in world space. A default constructed box is empty
+// (min above max), so growing it by another box yields that box.
+struct BoundingBox
+{
+    static constexpr auto infinity = std::numeric_limits<float>::infinity();
+
+    std::array<float, 3> min{infinity, infinity, infinity};
+    std::array<float, 3> max{-infinity, -infinity, -infinity};
+
+    auto grow(const BoundingBox& other) noexcept -> void
+    {
+        for (std::size_t axis{0}; axis < 3; ++axis) {
+            min[axis] = std::min(min[axis], other.min[axis]);
+            max[axis] = std::max(max[axis], other.max[axis]);
+        }
+    }
+
+    auto grow(float x, float y, float z) noexcept -> void
+    {
+        grow(BoundingBox{{x, y, z}, {x, y, z}});
+    }
+
+    auto empty() const noexcept -> bool
+    {
+        return min[0] > max[0] || min[1] > max[1] || min[2] > max[2];
+    }
+
+    auto centroid(std::size_t axis) const noexcept -> float
+    {
+        return 0.5f*(min[axis] + max[axis]);
+    }
+
+    auto surfaceArea() const noexcept -> float
+    {
+        if (empty()) {
+            return 0.f;
+        }
+        const auto x = max[0] - min[0];
+        const auto y = max[1] - min[1];
+        const auto z = max[2] - min[2];
+        return 2.f*(x*y + y*z + z*x);
+    }
+};
+
+inline auto operator==(const BoundingBox& lhs, const BoundingBox& rhs) -> bool
+{
+    return lhs.min == rhs.min && lhs.max == rhs.max;
+}
@@ -0,0 +1,216 @@
+#include "Bvh.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace
+{
+// Past this depth nodes are split at the object median, which halves the
+// primitive count each level and keeps traversal within Bvh::stackSize.
+constexpr std::size_t sahDepthLimit{64};
+// cost of visiting a node relative to intersecting one primitive
+constexpr auto traversalCost = 1.f;
+
+struct Bin
+{
+    BoundingBox bounds;
+    std::size_t count{0};
+};
+
+struct Split
+{
+    std::size_t axis{0};
+    std::size_t bin{0};
+    float cost{std::numeric_limits<float>::infinity()};
+};
+}
+
+Bvh::Bvh(const std::vector<BoundingBox>& primitives)
+{
+    if (primitives.empty()) {
+        return;
+    }
+    if (primitives.size() > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::runtime_error("Too many primitives for a BVH");
+    }
+    _primitives.resize(primitives.size());
+    for (std::size_t i{0}; i < primitives.size(); ++i) {
+        _primitives[i] = static_cast<std::uint32_t>(i);
+    }
+    _nodes.reserve(2*primitives.size());
+    _nodes.resize(2);
+
+    struct Task
+    {
+        std::uint32_t node;
+        std::size_t begin;
+        std::size_t end;
+        std::size_t depth;
+    };
+    std::vector<Task> tasks{Task{0, 0, primitives.size(), 1}};
+    while (!tasks.empty()) {
+        const auto task = tasks.back();
+        tasks.pop_back();
+        _depth = std::max(_depth, task.depth);
+        const auto middle = split(task.node, task.begin, task.end, task.depth, primitives);
+        if (middle == task.end) {
+            continue;
+        }
+        const auto left = _nodes[task.node].offset;
+        tasks.push_back(Task{left + 1, middle, task.end, task.depth + 1});
+        tasks.push_back(Task{left, task.begin, middle, task.depth + 1});
+    }
+}
+
+// Makes `node` a leaf over [begin, end) and returns end, or turns it into
+// an interior node with two fresh children and returns where the
+// primitives were partitioned.
+auto Bvh::split(std::uint32_t node, std::size_t begin, std::size_t end, std::size_t depth,
+                const std::vector<BoundingBox>& primitives) -> std::size_t
+{
+    BoundingBox bounds;
+    BoundingBox centroids;
+    for (auto i = begin; i < end; ++i) {
+        const auto& box = primitives[_primitives[i]];
+        bounds.grow(box);
+        centroids.grow(box.centroid(0), box.centroid(1), box.centroid(2));
+    }
+    _nodes[node].bounds = bounds;
+    const auto count = end - begin;
+    const auto makeLeaf = [&]() {
+        _nodes[node].offset = static_cast<std::uint32_t>(begin);
+        _nodes[node].count = static_cast<std::uint32_t>(count);
+        return end;
+    };
+    if (count == 1) {
+        return makeLeaf();
+    }
+
+    Split best;
+    if (depth < sahDepthLimit) {
+        for (std::size_t axis{0}; axis < 3; ++axis) {
+            const auto low = centroids.min[axis];
+            const auto extent = centroids.max[axis] - low;
+            if (!(extent > 0.f)) {
+                continue;
+            }
+            const auto scale = static_cast<float>(binCount)/extent;
+            std::array<Bin, binCount> bins{};
+            for (auto i = begin; i < end; ++i) {
+                const auto& box = primitives[_primitives[i]];
+                const auto bin = std::min(binCount - 1,
+                                          static_cast<std::size_t>((box.centroid(axis) - low)*scale));
+                bins[bin].bounds.grow(box);
+                ++bins[bin].count;
+            }
+            // areas and counts of everything right of each bin boundary
+            std::array<float, binCount> rightArea{};
+            std::array<std::size_t, binCount> rightCount{};
+            BoundingBox right;
+            std::size_t rightPrimitives{0};
+            for (auto bin = binCount - 1; bin > 0; --bin) {
+                right.grow(bins[bin].bounds);
+                rightPrimitives += bins[bin].count;
+                rightArea[bin] = right.surfaceArea();
+                rightCount[bin] = rightPrimitives;
+            }
+            BoundingBox left;
+            std::size_t leftPrimitives{0};
+            for (std::size_t bin{1}; bin < binCount; ++bin) {
+                left.grow(bins[bin - 1].bounds);
+                leftPrimitives += bins[bin - 1].count;
+                const auto cost = left.surfaceArea()*static_cast<float>(leftPrimitives) +
+                                  rightArea[bin]*static_cast<float>(rightCount[bin]);
+                if (leftPrimitives > 0 && rightCount[bin] > 0 && cost < best.cost) {
+                    best = Split{axis, bin, cost};
+                }
+            }
+        }
+    }
+
+    const auto area = bounds.surfaceArea();
+    const auto leafCost = static_cast<float>(count);
+    const auto splitCost = area > 0.f ? traversalCost + best.cost/area : leafCost;
+    if (count <= maxLeafSize && !(splitCost < leafCost)) {
+        return makeLeaf();
+    }
+
+    const auto first = _primitives.begin() + static_cast<std::ptrdiff_t>(begin);
+    const auto last = _primitives.begin() + static_cast<std::ptrdiff_t>(end);
+    auto middle = first;
+    if (best.cost != std::numeric_limits<float>::infinity()) {
+        const auto low = centroids.min[best.axis];
+        const auto scale = static_cast<float>(binCount)/(centroids.max[best.axis] - low);
+        middle = std::partition(first, last, [&](std::uint32_t id) {
+            const auto bin = std::min(binCount - 1,
+                                      static_cast<std::size_t>((primitives[id].centroid(best.axis) - low)*scale));
+            return bin < best.bin;
+        });
+    }
+    if (middle == first || middle == last) {
+        // no usable SAH split: halve at the median of the widest centroid axis
+        std::size_t axis{0};
+        for (std::size_t candidate{1}; candidate < 3; ++candidate) {
+            if (centroids.max[candidate] - centroids.min[candidate] >
+                centroids.max[axis] - centroids.min[axis]) {
+                axis = candidate;
+            }
+        }
+        middle = first + static_cast<std::ptrdiff_t>(count/2);
+        std::nth_element(first, middle, last, [&](std::uint32_t lhs, std::uint32_t rhs) {
+            return primitives[lhs].centroid(axis) < primitives[rhs].centroid(axis);
+        });
+    }
+
+    const auto children = static_cast<std::uint32_t>(_nodes.size());
+    _nodes.resize(_nodes.size() + 2);
+    _nodes[node].offset = children;
+    _nodes[node].count = 0;
+    return begin + static_cast<std::size_t>(middle - first);
+}
+
+// Children always come after their parent, so one backwards sweep sees
+// every child before the node that encloses it.
+auto Bvh::refit(const std::vector<BoundingBox>& primitives) -> void
+{
+    if (primitives.size() != _primitives.size()) {
+        throw std::runtime_error("Refit needs the bounds of every primitive of the BVH");
+    }
+    for (auto node = _nodes.size(); node-- > 0;) {
+        if (node == 1) {
+            continue;
+        }
+        auto& current = _nodes[node];
+        BoundingBox bounds;
+        if (current.leaf()) {
+            for (auto i = current.offset; i < current.offset + current.count; ++i) {
+                bounds.grow(primitives[_primitives[i]]);
+            }
+        } else {
+            bounds.grow(_nodes[current.offset].bounds);
+            bounds.grow(_nodes[current.offset + 1].bounds);
+        }
+        current.bounds = bounds;
+    }
+}
+
+auto Bvh::empty() const noexcept -> bool
+{
+    return _nodes.empty();
+}
+
+auto Bvh::nodes() const noexcept -> const NodeArray&
+{
+    return _nodes;
+}
+
+auto Bvh::primitives() const noexcept -> const std::vector<std::uint32_t>&
+{
+    return _primitives;
+}
+
+auto Bvh::depth() const noexcept -> std::size_t
+{
+    return _depth;
+}
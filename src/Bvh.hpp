@@ -0,0 +1,239 @@
+#pragma once
+
+#include "AlignedAllocator.hpp"
+#include "BoundingBox.hpp"
+#include "Instrumentation.hpp"
+#include "Intersection.hpp"
+#include "Ray.hpp"
+#include "RayPacket.hpp"
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// 32 bytes, so two siblings share one cache line.
+struct alignas(32) BvhNode
+{
+    BoundingBox bounds;
+    // leaf: first entry in Bvh::primitives(), interior: left child, the
+    // right child directly follows it
+    std::uint32_t offset{0};
+    // primitives in a leaf, 0 for interior nodes
+    std::uint32_t count{0};
+
+    auto leaf() const noexcept -> bool
+    {
+        return count != 0;
+    }
+};
+
+static_assert(sizeof(BvhNode) == 32, "BvhNode should fill half a cache line");
+
+// Bounding volume hierarchy over primitives known only by their boxes and
+// ids (indices into the box list passed to the constructor). Built top
+// down with a binned surface area heuristic into a flat node array. The
+// root is node 0 and node 1 is unused, so every sibling pair starts on a
+// cache line.
+//
+// Traversal calls back into the owner for the primitives of each leaf it
+// reaches; refit() updates the boxes after primitives moved without
+// changing the tree.
+class Bvh
+{
+    public:
+        static constexpr std::size_t maxLeafSize{4};
+        static constexpr std::size_t binCount{16};
+        static constexpr std::size_t stackSize{128};
+
+        using NodeArray = std::vector<BvhNode, AlignedAllocator<BvhNode, 64>>;
+
+        Bvh() = default;
+        explicit Bvh(const std::vector<BoundingBox>& primitives);
+
+        auto refit(const std::vector<BoundingBox>& primitives) -> void;
+        auto empty() const noexcept -> bool;
+        auto nodes() const noexcept -> const NodeArray&;
+        auto primitives() const noexcept -> const std::vector<std::uint32_t>&;
+        auto depth() const noexcept -> std::size_t;
+
+        // `intersect(id)` returns the nearest non-negative t at which the ray
+        // hits primitive `id`, if any. Equal distances resolve to the lower
+        // id, so the result does not depend on the tree's shape.
+        template<typename Intersect>
+        auto nearest(const Ray& ray, Intersect&& intersect) const -> std::optional<Intersection>;
+        // same, adding the number of nodes it visited to `visited`
+        template<typename Intersect>
+        auto nearest(const Ray& ray, Intersect&& intersect, std::size_t& visited) const
+            -> std::optional<Intersection>;
+
+        // `intersect(id)` updates `hits` with primitive `id`; nodes are
+        // skipped once every active lane has a hit closer than their box.
+        template<std::size_t lanes, typename Intersect>
+        auto intersect(const RayPacket<lanes>& packet, const PacketHits<lanes>& hits,
+                       Intersect&& intersect) const -> void;
+
+    private:
+        auto split(std::uint32_t node, std::size_t begin, std::size_t end, std::size_t depth,
+                   const std::vector<BoundingBox>& primitives) -> std::size_t;
+
+        NodeArray _nodes;
+        std::vector<std::uint32_t> _primitives;
+        std::size_t _depth{0};
+};
+
+namespace bvh
+{
+// Slab test of one ray. Returns the distance at which the ray enters the
+// box, or infinity when it misses it or enters beyond `limit`.
+class RayBoxTest
+{
+    public:
+        explicit RayBoxTest(const Ray& ray) noexcept
+        {
+            for (std::size_t axis{0}; axis < 3; ++axis) {
+                _origin[axis] = ray.origin()[axis];
+                _inverse[axis] = 1.f/ray.direction()[axis];
+            }
+        }
+
+        auto entry(const BoundingBox& box, float limit) const noexcept -> float
+        {
+            auto near = 0.f;
+            auto far = limit;
+            for (std::size_t axis{0}; axis < 3; ++axis) {
+                const auto t0 = (box.min[axis] - _origin[axis])*_inverse[axis];
+                const auto t1 = (box.max[axis] - _origin[axis])*_inverse[axis];
+                // NaN from 0*inf, an origin on a slab of a parallel ray,
+                // leaves near and far unchanged
+                near = std::max(near, std::min(t0, t1));
+                far = std::min(far, std::max(t0, t1));
+            }
+            return near <= far ? near : BoundingBox::infinity;
+        }
+
+    private:
+        std::array<float, 3> _origin{};
+        std::array<float, 3> _inverse{};
+};
+}
+
+template<typename Intersect>
+auto Bvh::nearest(const Ray& ray, Intersect&& intersect) const -> std::optional<Intersection>
+{
+    std::size_t visited{0};
+    return nearest(ray, intersect, visited);
+}
+
+template<typename Intersect>
+auto Bvh::nearest(const Ray& ray, Intersect&& intersect, std::size_t& visited) const -> std::optional<Intersection>
+{
+    std::optional<Intersection> hit;
+    if (_nodes.empty()) {
+        return hit;
+    }
+    const bvh::RayBoxTest test{ray};
+    auto limit = BoundingBox::infinity;
+    struct Pending
+    {
+        std::uint32_t node;
+        float entry;
+    };
+    std::array<Pending, stackSize> stack;
+    std::size_t size{0};
+    if (test.entry(_nodes[0].bounds, limit) != BoundingBox::infinity) {
+        stack[size++] = Pending{0, 0.f};
+    }
+    std::size_t nodes{0};
+    while (size > 0) {
+        const auto pending = stack[--size];
+        if (pending.entry > limit) {
+            continue;
+        }
+        ++nodes;
+        const auto& node = _nodes[pending.node];
+        if (node.leaf()) {
+            for (auto i = node.offset; i < node.offset + node.count; ++i) {
+                const auto id = _primitives[i];
+                const auto t = intersect(static_cast<std::size_t>(id));
+                if (t && (!hit || *t < hit->t || (*t == hit->t && id < hit->object))) {
+                    hit = Intersection{*t, id};
+                    limit = *t;
+                }
+            }
+            continue;
+        }
+        const auto left = node.offset;
+        const auto right = node.offset + 1;
+        const auto leftEntry = test.entry(_nodes[left].bounds, limit);
+        const auto rightEntry = test.entry(_nodes[right].bounds, limit);
+        // the nearer child goes on top, so it is visited first
+        const auto leftFirst = leftEntry <= rightEntry;
+        const Pending near{leftFirst ? left : right, leftFirst ? leftEntry : rightEntry};
+        const Pending far{leftFirst ? right : left, leftFirst ? rightEntry : leftEntry};
+        if (far.entry != BoundingBox::infinity) {
+            stack[size++] = far;
+        }
+        if (near.entry != BoundingBox::infinity) {
+            stack[size++] = near;
+        }
+    }
+    instrument::count(instrument::Counter::bvhNodes, nodes);
+    visited += nodes;
+    return hit;
+}
+
+template<std::size_t lanes, typename Intersect>
+auto Bvh::intersect(const RayPacket<lanes>& packet, const PacketHits<lanes>& hits,
+                    Intersect&& intersect) const -> void
+{
+    if (_nodes.empty()) {
+        return;
+    }
+    alignas(64) std::array<float, lanes> inverseX;
+    alignas(64) std::array<float, lanes> inverseY;
+    alignas(64) std::array<float, lanes> inverseZ;
+    for (std::size_t lane{0}; lane < lanes; ++lane) {
+        inverseX[lane] = 1.f/packet.directionX[lane];
+        inverseY[lane] = 1.f/packet.directionY[lane];
+        inverseZ[lane] = 1.f/packet.directionZ[lane];
+    }
+    const auto anyLane = [&](const BoundingBox& box) {
+        std::uint32_t any{0};
+        for (std::size_t lane{0}; lane < lanes; ++lane) {
+            const auto x0 = (box.min[0] - packet.originX[lane])*inverseX[lane];
+            const auto x1 = (box.max[0] - packet.originX[lane])*inverseX[lane];
+            const auto y0 = (box.min[1] - packet.originY[lane])*inverseY[lane];
+            const auto y1 = (box.max[1] - packet.originY[lane])*inverseY[lane];
+            const auto z0 = (box.min[2] - packet.originZ[lane])*inverseZ[lane];
+            const auto z1 = (box.max[2] - packet.originZ[lane])*inverseZ[lane];
+            const auto near = std::max(std::max(0.f, std::min(x0, x1)),
+                                       std::max(std::min(y0, y1), std::min(z0, z1)));
+            const auto far = std::min(std::min(hits.t[lane], std::max(x0, x1)),
+                                      std::min(std::max(y0, y1), std::max(z0, z1)));
+            any |= packet.active[lane] & static_cast<std::uint32_t>(near <= far);
+        }
+        return any != 0;
+    };
+
+    std::array<std::uint32_t, stackSize> stack;
+    std::size_t size{0};
+    stack[size++] = 0;
+    std::size_t visited{0};
+    while (size > 0) {
+        const auto& node = _nodes[stack[--size]];
+        if (!anyLane(node.bounds)) {
+            continue;
+        }
+        ++visited;
+        if (node.leaf()) {
+            for (auto i = node.offset; i < node.offset + node.count; ++i) {
+                intersect(static_cast<std::size_t>(_primitives[i]));
+            }
+            continue;
+        }
+        stack[size++] = node.offset + 1;
+        stack[size++] = node.offset;
+    }
+    instrument::count(instrument::Counter::bvhNodes, visited);
+}
@@ -0,0 +1,71 @@
+#include "Camera.hpp"
+
+#include <cmath>
+
+Camera::Camera(std::size_t hsize, std::size_t vsize, float fieldOfView):
+    _hsize{hsize},
+    _vsize{vsize},
+    _fieldOfView{fieldOfView}
+{
+    const auto halfView = std::tan(_fieldOfView/2.f);
+    const auto aspect = static_cast<float>(_hsize)/static_cast<float>(_vsize);
+    if (aspect >= 1.f) {
+        _halfWidth = halfView;
+        _halfHeight = halfView/aspect;
+    } else {
+        _halfWidth = halfView*aspect;
+        _halfHeight = halfView;
+    }
+    _pixelSize = _halfWidth*2.f/static_cast<float>(_hsize);
+}
+
+auto Camera::setTransform(const Mat4& matrix) -> void
+{
+    setTransform(Transform{matrix});
+}
+
+auto Camera::setTransform(const Transform& transform) -> void
+{
+    _transform = transform;
+    _origin = _transform.affineInverse()*Point4{0.f, 0.f, 0.f, 1.f};
+}
+
+auto Camera::transform() const -> const Transform&
+{
+    return _transform;
+}
+
+auto Camera::hsize() const -> std::size_t
+{
+    return _hsize;
+}
+
+auto Camera::vsize() const -> std::size_t
+{
+    return _vsize;
+}
+
+auto Camera::fieldOfView() const -> float
+{
+    return _fieldOfView;
+}
+
+auto Camera::pixelSize() const -> float
+{
+    return _pixelSize;
+}
+
+auto Camera::rayForPixel(std::size_t x, std::size_t y) const -> Ray
+{
+    return rayForPixel(x, y, 0.5f, 0.5f);
+}
+
+auto Camera::rayForPixel(std::size_t x, std::size_t y, float dx, float dy) const -> Ray
+{
+    const auto xOffset = (static_cast<float>(x) + dx)*_pixelSize;
+    const auto yOffset = (static_cast<float>(y) + dy)*_pixelSize;
+    const auto worldX = _halfWidth - xOffset;
+    const auto worldY = _halfHeight - yOffset;
+    const auto pixel = _transform.affineInverse()*Point4{worldX, worldY, -1.f, 1.f};
+    return Ray{_origin, normalize(pixel - _origin)};
+}
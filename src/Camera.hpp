@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Point.hpp"
+#include "Ray.hpp"
+#include "Transformations.hpp"
+
+#include <cstdint>
+
+// Pinhole camera looking down -z from the origin onto a canvas one unit
+// away; its transformation moves the world relative to the eye.
+class Camera
+{
+    public:
+        explicit Camera(std::size_t hsize, std::size_t vsize, float fieldOfView);
+
+        auto setTransform(const Mat4& matrix) -> void;
+        auto setTransform(const Transform& transform) -> void;
+        auto transform() const -> const Transform&;
+        auto hsize() const -> std::size_t;
+        auto vsize() const -> std::size_t;
+        auto fieldOfView() const -> float;
+        auto pixelSize() const -> float;
+        auto rayForPixel(std::size_t x, std::size_t y) const -> Ray;
+        // through the point (dx, dy) of the pixel, both in [0, 1); the
+        // centre is (0.5, 0.5)
+        auto rayForPixel(std::size_t x, std::size_t y, float dx, float dy) const -> Ray;
+
+    private:
+        std::size_t _hsize;
+        std::size_t _vsize;
+        float _fieldOfView;
+        float _halfWidth{};
+        float _halfHeight{};
+        float _pixelSize{};
+        Transform _transform;
+        Point4 _origin{0.f, 0.f, 0.f, 1.f};
+};
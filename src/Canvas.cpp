@@ -1,26 +1,251 @@
 #include "Canvas.hpp"
 #include "Color.hpp"
+#include "Instrumentation.hpp"
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+#include "Utilities.hpp"
 
 #include <stdexcept>
 #include <fstream>
 #include <algorithm>
-#include <cmath>
-#include <sstream>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <string>
+#include <utility>
+
+namespace
+{
+// Layout of a mapped framebuffer file: this header, padded to a cache line,
+// followed by the pixels in storage order.
+constexpr char framebufferMagic[8]{'R', 'T', 'C', 'A', 'N', 'V', 'A', 'S'};
+
+struct alignas(64) FramebufferHeader
+{
+    char magic[8];
+    std::uint64_t width;
+    std::uint64_t height;
+    std::uint64_t pixelSize;
+    std::uint64_t layout;
+    std::uint64_t format;
+};
+
+auto tileShift(CanvasLayout layout) noexcept -> std::size_t
+{
+    switch (layout) {
+    case CanvasLayout::tiled8:
+        return 3;
+    case CanvasLayout::tiled32:
+    case CanvasLayout::morton:
+        return 5;
+    default:
+        return 0;
+    }
+}
+
+auto tileCount(std::size_t pixels, std::size_t shift) noexcept -> std::size_t
+{
+    return (pixels + (std::size_t{1} << shift) - 1) >> shift;
+}
+
+auto paddedSize(std::size_t width, std::size_t height, CanvasLayout layout) noexcept -> std::size_t
+{
+    const auto shift = tileShift(layout);
+    return (tileCount(width, shift)*tileCount(height, shift)) << (2*shift);
+}
+
+// pixel bytes of a framebuffer file as read from its header; nothing when
+// they would not fit in memory next to the header
+auto framebufferBytes(std::uint64_t width,
+                      std::uint64_t height,
+                      CanvasLayout layout,
+                      std::uint64_t pixelSize) noexcept -> std::optional<std::size_t>
+{
+    constexpr auto limit = std::numeric_limits<std::size_t>::max() - sizeof(FramebufferHeader);
+    const auto shift = tileShift(layout);
+    const auto tileSide = std::size_t{1} << shift;
+    if (width > limit - tileSide || height > limit - tileSide) {
+        return std::nullopt;
+    }
+    const auto tileColumns = tileCount(width, shift);
+    const auto tileRows = tileCount(height, shift);
+    const auto tileBytes = tileSide*tileSide*pixelSize;
+    if (tileRows != 0 && tileColumns > limit/tileRows) {
+        return std::nullopt;
+    }
+    const auto tiles = tileColumns*tileRows;
+    if (tiles != 0 && tileBytes > limit/tiles) {
+        return std::nullopt;
+    }
+    return tiles*tileBytes;
+}
+
+// moves bit i of a 16 bit value to bit 2i
+constexpr auto spreadBits(std::size_t value) noexcept -> std::size_t
+{
+    value = (value | value << 8) & 0x00ff00ff;
+    value = (value | value << 4) & 0x0f0f0f0f;
+    value = (value | value << 2) & 0x33333333;
+    return (value | value << 1) & 0x55555555;
+}
+
+// inverse of spreadBits, ignoring the odd bits
+constexpr auto compactBits(std::size_t value) noexcept -> std::size_t
+{
+    value &= 0x55555555;
+    value = (value | value >> 1) & 0x33333333;
+    value = (value | value >> 2) & 0x0f0f0f0f;
+    value = (value | value >> 4) & 0x00ff00ff;
+    return (value | value >> 8) & 0x0000ffff;
+}
+
+// Plain PPM lines must not exceed 70 characters. Every row starts a new
+// line and values are moved to the next line rather than split.
+constexpr std::size_t maxPlainLineLength{70};
+// up to three digits and one separator per channel
+constexpr std::size_t maxPlainChannelLength{4};
+
+// row buffer of the calling thread for rows that have to be gathered
+auto rowScratch(std::size_t width) -> Color*
+{
+    thread_local std::vector<Color> scratch;
+    if (scratch.size() < width) {
+        scratch.resize(width);
+    }
+    return scratch.data();
+}
+
+// Saving encodes and writes blocks of rows of about this many bytes, so a
+// mapped canvas larger than memory is not copied into memory whole.
+constexpr std::size_t saveBlockBytes{std::size_t{1} << 20};
+
+auto rowsPerBlock(std::size_t rowBytes) noexcept -> std::size_t
+{
+    return std::max<std::size_t>(saveBlockBytes/std::max<std::size_t>(rowBytes, 1), 1);
+}
+
+// calls encode(y) for rows first to first + count, on the pool when there
+// is one
+template<typename Encode>
+auto forEachRow(std::size_t first, std::size_t count, ThreadPool* pool, const Encode& encode) -> void
+{
+    if (pool) {
+        pool->run(count, [&](std::size_t i) { encode(first + i); });
+    } else {
+        for (auto y = first; y < first + count; ++y) {
+            encode(y);
+        }
+    }
+}
+}
 
 Canvas::Canvas(std::size_t width, std::size_t height):
-    _width{width},
-    _height{height},
-    _canvas(width*height, Color{0.f, 0.f, 0.f})
+    Canvas{width, height, Color{0.f, 0.f, 0.f}, CanvasLayout::rowMajor}
 {}
 
 Canvas::Canvas(std::size_t width,
                std::size_t height,
                const Color& background):
+    Canvas{width, height, background, CanvasLayout::rowMajor}
+{}
+
+Canvas::Canvas(std::size_t width,
+               std::size_t height,
+               const Color& background,
+               CanvasLayout layout,
+               PixelFormat format):
     _width{width},
     _height{height},
-    _canvas(_width*_height, background)
+    _layout{layout},
+    _format{format},
+    _tileShift{tileShift(layout)},
+    _tileColumns{tileCount(width, _tileShift)},
+    _storageSize{paddedSize(width, height, layout)},
+    _canvas(_storageSize*bytesPerPixel(format)),
+    _pixels{_canvas.data()}
+{
+    fill(background);
+}
+
+Canvas::Canvas(std::size_t width,
+               std::size_t height,
+               CanvasLayout layout,
+               PixelFormat format,
+               MappedFile mapping):
+    _width{width},
+    _height{height},
+    _layout{layout},
+    _format{format},
+    _tileShift{tileShift(layout)},
+    _tileColumns{tileCount(width, _tileShift)},
+    _storageSize{paddedSize(width, height, layout)},
+    _mapping{std::move(mapping)},
+    _pixels{_mapping.data() + sizeof(FramebufferHeader)}
+{}
+
+Canvas::Canvas(const Canvas& other):
+    _width{other._width},
+    _height{other._height},
+    _layout{other._layout},
+    _format{other._format},
+    _tileShift{other._tileShift},
+    _tileColumns{other._tileColumns},
+    _storageSize{other._storageSize},
+    _canvas(other._pixels, other._pixels + other._storageSize*bytesPerPixel(other._format)),
+    _pixels{_canvas.data()}
 {}
 
+auto Canvas::createMapped(const std::filesystem::path& filePath,
+                          std::size_t width,
+                          std::size_t height,
+                          CanvasLayout layout,
+                          PixelFormat format) -> Canvas
+{
+    auto mapping = MappedFile::create(filePath, sizeof(FramebufferHeader) +
+                                                paddedSize(width, height, layout)*bytesPerPixel(format));
+    FramebufferHeader header{{}, width, height, bytesPerPixel(format),
+                             static_cast<std::uint64_t>(layout), static_cast<std::uint64_t>(format)};
+    std::copy(std::begin(framebufferMagic), std::end(framebufferMagic), header.magic);
+    std::memcpy(mapping.data(), &header, sizeof(header));
+    return Canvas{width, height, layout, format, std::move(mapping)};
+}
+
+auto Canvas::createMapped(const std::filesystem::path& filePath,
+                          std::size_t width,
+                          std::size_t height,
+                          const Color& background,
+                          CanvasLayout layout,
+                          PixelFormat format) -> Canvas
+{
+    auto canvas = createMapped(filePath, width, height, layout, format);
+    canvas.fill(background);
+    return canvas;
+}
+
+auto Canvas::openMapped(const std::filesystem::path& filePath) -> Canvas
+{
+    auto mapping = MappedFile::open(filePath);
+    FramebufferHeader header{};
+    if (mapping.size() >= sizeof(header)) {
+        std::memcpy(&header, mapping.data(), sizeof(header));
+    }
+    const auto layout = static_cast<CanvasLayout>(header.layout);
+    const auto format = static_cast<PixelFormat>(header.format);
+    const auto valid = std::memcmp(header.magic, framebufferMagic, sizeof(framebufferMagic)) == 0 &&
+                       header.layout <= static_cast<std::uint64_t>(CanvasLayout::morton) &&
+                       header.format <= static_cast<std::uint64_t>(PixelFormat::srgb8) &&
+                       header.pixelSize == bytesPerPixel(format);
+    const auto pixelBytes = valid ? framebufferBytes(header.width, header.height, layout, header.pixelSize)
+                                  : std::nullopt;
+    if (!pixelBytes || mapping.size() != sizeof(header) + *pixelBytes) {
+        throw std::runtime_error("Not a canvas framebuffer: " + filePath.string());
+    }
+    return Canvas{header.width, header.height, layout, format, std::move(mapping)};
+}
+
 auto Canvas::height() const -> std::size_t
 {
     return _height;
@@ -31,77 +256,366 @@ auto Canvas::width() const -> std::size_t
     return _width;
 }
 
-auto Canvas::getPixel(std::size_t x, std::size_t y) const -> const Color&
+auto Canvas::getPixel(std::size_t x, std::size_t y) const -> Color
 {
-    return _canvas[coordToIndex(x, y)];
+    return load(coordToIndex(x, y));
 }
 
 auto Canvas::setPixel(std::size_t x, std::size_t y, const Color& color) -> void
 {
-    _canvas[coordToIndex(x, y)] = color;
+    store(coordToIndex(x, y), color);
 }
 
-auto Canvas::writePpmHeader(std::ofstream& file) const -> void
+auto Canvas::operator()(std::size_t x, std::size_t y) const noexcept -> Color
 {
-    file << "P3\n";
-    file << _width << " " << _height << '\n';
-    file << 255 << '\n';
+    return load(uncheckedIndex(x, y));
 }
 
-auto Canvas::scaleColor(float color) const -> int
+auto Canvas::operator()(std::size_t x, std::size_t y) noexcept -> PixelRef
 {
-    if (color <= 0) {
-         return 0;
-    } else if (color >= 1) {
-        return 255;
-    } else {
-        return static_cast<int>(std::ceil(255*color));
+    return PixelRef{*this, uncheckedIndex(x, y)};
+}
+
+Canvas::PixelRef::PixelRef(Canvas& canvas, std::size_t index) noexcept:
+    _canvas{&canvas},
+    _index{index}
+{}
+
+auto Canvas::PixelRef::operator=(const Color& color) noexcept -> PixelRef&
+{
+    _canvas->store(_index, color);
+    return *this;
+}
+
+auto Canvas::PixelRef::operator=(const PixelRef& other) noexcept -> PixelRef&
+{
+    return *this = static_cast<Color>(other);
+}
+
+Canvas::PixelRef::operator Color() const noexcept
+{
+    return _canvas->load(_index);
+}
+
+auto Canvas::load(std::size_t index) const noexcept -> Color
+{
+    switch (_format) {
+    case PixelFormat::planarFloat: {
+        const auto* const planes = reinterpret_cast<const float*>(_pixels);
+        return Color{planes[index], planes[_storageSize + index], planes[2*_storageSize + index]};
+    }
+    case PixelFormat::rgbHalf: {
+        const auto* const channels = reinterpret_cast<const std::uint16_t*>(_pixels) + 3*index;
+        return Color{fromHalf(channels[0]), fromHalf(channels[1]), fromHalf(channels[2])};
+    }
+    case PixelFormat::srgb8: {
+        const auto* const channels = reinterpret_cast<const std::uint8_t*>(_pixels) + 3*index;
+        return Color{decodeSrgb8(channels[0]), decodeSrgb8(channels[1]), decodeSrgb8(channels[2])};
+    }
+    default:
+        return reinterpret_cast<const Color*>(_pixels)[index];
+    }
+}
+
+auto Canvas::store(std::size_t index, const Color& color) noexcept -> void
+{
+    switch (_format) {
+    case PixelFormat::planarFloat: {
+        auto* const planes = reinterpret_cast<float*>(_pixels);
+        planes[index] = color.r();
+        planes[_storageSize + index] = color.g();
+        planes[2*_storageSize + index] = color.b();
+        break;
+    }
+    case PixelFormat::rgbHalf: {
+        auto* const channels = reinterpret_cast<std::uint16_t*>(_pixels) + 3*index;
+        channels[0] = toHalf(color.r());
+        channels[1] = toHalf(color.g());
+        channels[2] = toHalf(color.b());
+        break;
+    }
+    case PixelFormat::srgb8: {
+        auto* const channels = reinterpret_cast<std::uint8_t*>(_pixels) + 3*index;
+        channels[0] = encodeSrgb8(color.r());
+        channels[1] = encodeSrgb8(color.g());
+        channels[2] = encodeSrgb8(color.b());
+        break;
     }
+    default:
+        reinterpret_cast<Color*>(_pixels)[index] = color;
+    }
+}
+
+auto Canvas::pixelAt(std::size_t index) const noexcept -> Color
+{
+    return load(index);
+}
+
+auto Canvas::pixelAt(std::size_t index) noexcept -> PixelRef
+{
+    return PixelRef{*this, index};
+}
+
+// every stored pixel, padding included, so copies compare equal
+auto Canvas::fill(const Color& color) noexcept -> void
+{
+    for (std::size_t index{0}; index < _storageSize; ++index) {
+        store(index, color);
+    }
+}
+
+auto Canvas::layout() const noexcept -> CanvasLayout
+{
+    return _layout;
+}
+
+auto Canvas::storageSize() const noexcept -> std::size_t
+{
+    return _storageSize;
+}
+
+auto Canvas::format() const noexcept -> PixelFormat
+{
+    return _format;
 }
 
-auto Canvas::writePixelToFile(std::ostringstream& ss, const Color& pixel) const -> void
+auto Canvas::data() const noexcept -> const Color*
 {
-    ss << scaleColor(pixel.r()) << " ";
-    ss << scaleColor(pixel.g()) << " ";
-    ss << scaleColor(pixel.b()) << " ";
+    return _format == PixelFormat::rgbFloat ? reinterpret_cast<const Color*>(_pixels) : nullptr;
 }
 
-auto Canvas::splitLineIfNeeded(std::ostringstream& line) const -> void
+auto Canvas::data() noexcept -> Color*
 {
-    if (line.str().size() <= 70) {
+    return _format == PixelFormat::rgbFloat ? reinterpret_cast<Color*>(_pixels) : nullptr;
+}
+
+auto Canvas::plane(std::size_t channel) const noexcept -> const float*
+{
+    RAY_TRACER_ASSERT_INDEX(channel < 3);
+    return _format == PixelFormat::planarFloat
+               ? reinterpret_cast<const float*>(_pixels) + channel*_storageSize
+               : nullptr;
+}
+
+auto Canvas::plane(std::size_t channel) noexcept -> float*
+{
+    RAY_TRACER_ASSERT_INDEX(channel < 3);
+    return _format == PixelFormat::planarFloat
+               ? reinterpret_cast<float*>(_pixels) + channel*_storageSize
+               : nullptr;
+}
+
+auto Canvas::mapped() const noexcept -> bool
+{
+    return _mapping.data() != nullptr;
+}
+
+auto Canvas::flush() const -> void
+{
+    _mapping.flush();
+}
+
+auto Canvas::begin() noexcept -> iterator
+{
+    return iterator{*this, _width*_height == 0 ? _storageSize : 0};
+}
+
+auto Canvas::end() noexcept -> iterator
+{
+    return iterator{*this, _storageSize};
+}
+
+auto Canvas::begin() const noexcept -> const_iterator
+{
+    return const_iterator{*this, _width*_height == 0 ? _storageSize : 0};
+}
+
+auto Canvas::end() const noexcept -> const_iterator
+{
+    return const_iterator{*this, _storageSize};
+}
+
+auto Canvas::positionOf(std::size_t index) const noexcept -> Position
+{
+    if (_width == 0) {
+        return Position{index, 0, 0, 0, 0};
+    }
+    if (_tileShift == 0) {
+        return Position{index, index % _width, index/_width, 0, 0};
+    }
+    const auto tile = index >> (2*_tileShift);
+    const auto offset = index & ((std::size_t{1} << 2*_tileShift) - 1);
+    Position position{index, 0, 0, tile % _tileColumns, tile/_tileColumns};
+    if (_layout == CanvasLayout::morton) {
+        position.x = (position.tileX << _tileShift) + compactBits(offset);
+        position.y = (position.tileY << _tileShift) + compactBits(offset >> 1);
+    } else {
+        position.x = (position.tileX << _tileShift) + (offset & ((std::size_t{1} << _tileShift) - 1));
+        position.y = (position.tileY << _tileShift) + (offset >> _tileShift);
+    }
+    return position;
+}
+
+// Steps to the next stored pixel inside the canvas. Tile coordinates are
+// carried along, so only the offset within a tile is decoded.
+auto Canvas::advance(Position& position) const noexcept -> void
+{
+    if (_tileShift == 0) {
+        ++position.index;
+        if (++position.x == _width) {
+            position.x = 0;
+            ++position.y;
+        }
         return;
     }
-    auto tmp = line.str();
+    const auto mask = (std::size_t{1} << _tileShift) - 1;
+    do {
+        const auto offset = ++position.index & ((std::size_t{1} << 2*_tileShift) - 1);
+        if (offset == 0 && ++position.tileX == _tileColumns) {
+            position.tileX = 0;
+            ++position.tileY;
+        }
+        if (_layout == CanvasLayout::morton) {
+            position.x = (position.tileX << _tileShift) + compactBits(offset);
+            position.y = (position.tileY << _tileShift) + compactBits(offset >> 1);
+        } else {
+            position.x = (position.tileX << _tileShift) + (offset & mask);
+            position.y = (position.tileY << _tileShift) + (offset >> _tileShift);
+        }
+    } while (position.index < _storageSize && (position.x >= _width || position.y >= _height));
+}
+
+// Row y as row major float colors: straight from storage, or gathered and
+// converted into scratch (at least width pixels) for other layouts and
+// formats.
+auto Canvas::row(std::size_t y, Color* scratch) const noexcept -> const Color*
+{
+    if (_layout == CanvasLayout::rowMajor && _format == PixelFormat::rgbFloat) {
+        return reinterpret_cast<const Color*>(_pixels) + y*_width;
+    }
+    for (std::size_t x{0}; x < _width; ++x) {
+        scratch[x] = load(uncheckedIndex(x, y));
+    }
+    return scratch;
+}
+
+// Writes row y into out, which holds at least width*3*maxPlainChannelLength
+// characters, and returns the number of characters written. The row is
+// quantized into the last quarter of out first; text never catches up
+// with a byte before it has been read.
+auto Canvas::encodePlainRow(std::size_t y, const Quantization& quantization, char* out) const -> std::size_t
+{
+    auto* const codes = reinterpret_cast<std::uint8_t*>(out) + _width*3*(maxPlainChannelLength - 1);
+    quantizeRow8(row(y, rowScratch(_width)), _width, y, quantization, codes);
+    auto* const begin = out;
+    auto* lineStart = out;
+    for (std::size_t channel{0}; channel < _width*3; ++channel) {
+        char digits[3];
+        const auto length = static_cast<std::size_t>(
+            std::to_chars(digits, digits + sizeof(digits), codes[channel]).ptr - digits);
+        if (out != lineStart) {
+            if (static_cast<std::size_t>(out - lineStart) + 1 + length > maxPlainLineLength) {
+                *out++ = '\n';
+                lineStart = out;
+            } else {
+                *out++ = ' ';
+            }
+        }
+        out = std::copy(digits, digits + length, out);
+    }
+    *out++ = '\n';
+    return static_cast<std::size_t>(out - begin);
 }
 
-//TODO: remove trailing spaces and add spliting line to max 70 characters
-auto Canvas::writePpmContent(std::ofstream& file) const -> void
+// Each block of rows is encoded into fixed size slots of one buffer, in
+// parallel when a pool is given, then moved together and written at once.
+auto Canvas::writePlainPpm(std::ofstream& file, const Quantization& quantization, ThreadPool* pool) const -> void
 {
-    std::size_t lineNumberCount{0};
-    std::ostringstream line;
-    for(const auto& pixel: _canvas) {
-        if (lineNumberCount ==_width-1) {
-            lineNumberCount = 0;
-            writePixelToFile(line, pixel);
-            line << '\n';
-            splitLineIfNeeded(line);
-            file << line.str();
-            line.str("");
-            continue;
+    const auto header = "P3\n" + std::to_string(_width) + " " + std::to_string(_height) + "\n255\n";
+    file.write(header.data(), static_cast<std::streamsize>(header.size()));
+    const auto slot = std::max<std::size_t>(_width*3*maxPlainChannelLength, 1);
+    const auto blockRows = std::min(rowsPerBlock(slot), _height);
+    std::vector<char> buffer(blockRows*slot);
+    std::vector<std::size_t> lengths(blockRows);
+    for (std::size_t first{0}; first < _height; first += blockRows) {
+        const auto count = std::min(blockRows, _height - first);
+        forEachRow(first, count, pool, [&](std::size_t y) {
+            lengths[y - first] = encodePlainRow(y, quantization, buffer.data() + (y - first)*slot);
+        });
+        auto out = buffer.begin();
+        for (std::size_t i{0}; i < count; ++i) {
+            const auto row = buffer.begin() + static_cast<std::ptrdiff_t>(i*slot);
+            out = std::copy(row, row + static_cast<std::ptrdiff_t>(lengths[i]), out);
         }
-        ++lineNumberCount;
-        writePixelToFile(line, pixel);
+        file.write(buffer.data(), out - buffer.begin());
     }
 }
 
-auto Canvas::saveToFile(const std::filesystem::path& filePath) const -> void
+// Each block of rows is encoded into one buffer, in parallel when a pool is
+// given, and written at once.
+auto Canvas::writeBinaryPpm(std::ofstream& file,
+                            PpmFormat format,
+                            const Quantization& quantization,
+                            ThreadPool* pool) const -> void
+{
+    const auto wide = format == PpmFormat::binary16;
+    const auto header = "P6\n" + std::to_string(_width) + " " + std::to_string(_height) + "\n" +
+                        (wide ? "65535" : "255") + "\n";
+    file.write(header.data(), static_cast<std::streamsize>(header.size()));
+    const auto rowBytes = _width*3*(wide ? 2u : 1u);
+    const auto blockRows = std::min(rowsPerBlock(rowBytes), _height);
+    std::vector<std::uint8_t> buffer(blockRows*rowBytes);
+    for (std::size_t first{0}; first < _height; first += blockRows) {
+        const auto count = std::min(blockRows, _height - first);
+        forEachRow(first, count, pool, [&](std::size_t y) {
+            const auto* const colors = row(y, rowScratch(_width));
+            auto* const out = buffer.data() + (y - first)*rowBytes;
+            if (wide) {
+                quantizeRow16(colors, _width, y, quantization, out);
+            } else {
+                quantizeRow8(colors, _width, y, quantization, out);
+            }
+        });
+        file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(count*rowBytes));
+    }
+}
+
+auto Canvas::saveToFile(const std::filesystem::path& filePath,
+                        PpmFormat format,
+                        const Quantization& quantization) const -> void
+{
+    save(filePath, format, quantization, nullptr);
+}
+
+auto Canvas::saveToFile(const std::filesystem::path& filePath,
+                        PpmFormat format,
+                        ThreadPool& pool,
+                        const Quantization& quantization) const -> void
+{
+    save(filePath, format, quantization, &pool);
+}
+
+auto Canvas::save(const std::filesystem::path& filePath,
+                  PpmFormat format,
+                  const Quantization& quantization,
+                  ThreadPool* pool) const -> void
 {
-    std::ofstream file{filePath};
+    const instrument::ScopedPhase phase{instrument::Phase::save};
+    const trace::Span span{"save"};
+    std::ofstream file{filePath, std::ios::binary};
     if (!file) {
         throw std::runtime_error("Cannot open/create file");
     }
-    writePpmHeader(file);
-    writePpmContent(file);
+    if (format == PpmFormat::plain) {
+        writePlainPpm(file, quantization, pool);
+    } else {
+        writeBinaryPpm(file, format, quantization, pool);
+    }
+    // a failure to write back what is still buffered only shows on close
+    file.close();
+    if (!file) {
+        throw std::runtime_error("Cannot write file");
+    }
 }
 
 auto Canvas::coordToIndex(std::size_t x, std::size_t y) const -> std::size_t
@@ -109,5 +623,19 @@ auto Canvas::coordToIndex(std::size_t x, std::size_t y) const -> std::size_t
     if (x>=_width || y>=_height) {
         throw std::runtime_error("out of bounds");
     }
-    return y*_width + x;
+    return uncheckedIndex(x, y);
+}
+
+auto Canvas::uncheckedIndex(std::size_t x, std::size_t y) const noexcept -> std::size_t
+{
+    RAY_TRACER_ASSERT_INDEX(x < _width && y < _height);
+    if (_tileShift == 0) {
+        return y*_width + x;
+    }
+    const auto mask = (std::size_t{1} << _tileShift) - 1;
+    const auto tile = ((y >> _tileShift)*_tileColumns + (x >> _tileShift)) << 2*_tileShift;
+    if (_layout == CanvasLayout::morton) {
+        return tile + (spreadBits(y & mask) << 1 | spreadBits(x & mask));
+    }
+    return tile + ((y & mask) << _tileShift) + (x & mask);
 }
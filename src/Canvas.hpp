@@ -1,38 +1,245 @@
 #pragma once
 
+#include "AlignedAllocator.hpp"
+#include "MappedFile.hpp"
+#include "PixelFormat.hpp"
+#include "Quantize.hpp"
+
+#include <cstddef>
 #include <cstdint>
+#include <iterator>
 #include <vector>
 #include <string>
 #include <filesystem>
 
 class Color;
+class ThreadPool;
+
+// Netpbm color image flavours saveToFile() can write: plain text P3, or
+// binary P6 with one or two (big endian) bytes per channel.
+enum class PpmFormat
+{
+    plain,
+    binary8,
+    binary16
+};
 
+// Order of the pixels in memory. Tiled layouts store square tiles of 8 or
+// 32 pixels one after another, tile rows top to bottom, and the pixels of
+// a tile row by row; morton does the same with 32 pixel tiles whose pixels
+// follow the Z-order curve. Tiles at the right and bottom edge are padded
+// to full size.
+enum class CanvasLayout
+{
+    rowMajor,
+    tiled8,
+    tiled32,
+    morton
+};
+
+// Pixels are kept in memory, or for canvases larger than memory in a
+// framebuffer file mapped into memory, which the OS pages in and out. A
+// copy of a mapped canvas lives in memory. Pixels are read by value and
+// written through PixelRef, so every PixelFormat converts at the boundary.
 class Canvas
 {
     public:
         explicit Canvas(std::size_t width, std::size_t height);
         explicit Canvas(std::size_t width, std::size_t height, const Color& background);
+        explicit Canvas(std::size_t width,
+                        std::size_t height,
+                        const Color& background,
+                        CanvasLayout layout,
+                        PixelFormat format = PixelFormat::rgbFloat);
         ~Canvas() = default;
 
-        Canvas(const Canvas&) = default;
+        // New framebuffer file, with disk space for all its pixels reserved
+        // up front. Without a background it starts black.
+        static auto createMapped(const std::filesystem::path& filePath,
+                                 std::size_t width,
+                                 std::size_t height,
+                                 CanvasLayout layout = CanvasLayout::rowMajor,
+                                 PixelFormat format = PixelFormat::rgbFloat) -> Canvas;
+        static auto createMapped(const std::filesystem::path& filePath,
+                                 std::size_t width,
+                                 std::size_t height,
+                                 const Color& background,
+                                 CanvasLayout layout = CanvasLayout::rowMajor,
+                                 PixelFormat format = PixelFormat::rgbFloat) -> Canvas;
+        static auto openMapped(const std::filesystem::path& filePath) -> Canvas;
+
+        Canvas(const Canvas& other);
         auto operator=(const Canvas&) -> Canvas&;
         Canvas(Canvas&&) = default;
         auto operator=(Canvas&&) -> Canvas&;
 
-        auto getPixel(std::size_t x, std::size_t y) const -> const Color&;
+        // Writable pixel of any format, converting on assignment and read.
+        class PixelRef
+        {
+            public:
+                PixelRef(Canvas& canvas, std::size_t index) noexcept;
+                PixelRef(const PixelRef&) = default;
+
+                auto operator=(const Color& color) noexcept -> PixelRef&;
+                auto operator=(const PixelRef& other) noexcept -> PixelRef&;
+                operator Color() const noexcept;
+
+            private:
+                Canvas* _canvas;
+                std::size_t _index;
+        };
+
+        auto getPixel(std::size_t x, std::size_t y) const -> Color;
         auto setPixel(std::size_t x, std::size_t y, const Color& color) -> void;
         auto height() const -> std::size_t;
         auto width() const -> std::size_t;
-        auto saveToFile(const std::filesystem::path& filePath) const -> void;
+        auto saveToFile(const std::filesystem::path& filePath,
+                        PpmFormat format = PpmFormat::plain,
+                        const Quantization& quantization = {}) const -> void;
+        // Same file, with the rows encoded in parallel.
+        auto saveToFile(const std::filesystem::path& filePath,
+                        PpmFormat format,
+                        ThreadPool& pool,
+                        const Quantization& quantization = {}) const -> void;
+        auto operator()(std::size_t x, std::size_t y) const noexcept -> Color;
+        auto operator()(std::size_t x, std::size_t y) noexcept -> PixelRef;
+        auto layout() const noexcept -> CanvasLayout;
+        auto format() const noexcept -> PixelFormat;
+        // Pixels of an rgbFloat canvas in storage order, including the
+        // padding of edge tiles; null for other formats.
+        auto data() const noexcept -> const Color*;
+        auto data() noexcept -> Color*;
+        // Red, green or blue plane of a planarFloat canvas, in storage
+        // order like data(); null for other formats.
+        auto plane(std::size_t channel) const noexcept -> const float*;
+        auto plane(std::size_t channel) noexcept -> float*;
+        auto storageSize() const noexcept -> std::size_t;
+        auto mapped() const noexcept -> bool;
+        // writes the pixels of a mapped canvas back to its file
+        auto flush() const -> void;
+
+        template<typename ColorT>
+        struct Pixel
+        {
+            std::size_t x;
+            std::size_t y;
+            // position in storage order
+            std::size_t index;
+            ColorT color;
+        };
+
+        // Walks the pixels of the canvas in the order they are stored,
+        // skipping padding, so loops over all pixels touch memory linearly.
+        template<typename CanvasT, typename ColorT>
+        class StorageIterator;
+
+        using iterator = StorageIterator<Canvas, PixelRef>;
+        using const_iterator = StorageIterator<const Canvas, Color>;
+
+        auto begin() noexcept -> iterator;
+        auto end() noexcept -> iterator;
+        auto begin() const noexcept -> const_iterator;
+        auto end() const noexcept -> const_iterator;
+
     private:
+        // storage index of a pixel and the tile it belongs to
+        struct Position
+        {
+            std::size_t index;
+            std::size_t x;
+            std::size_t y;
+            std::size_t tileX;
+            std::size_t tileY;
+        };
+
+        explicit Canvas(std::size_t width,
+                        std::size_t height,
+                        CanvasLayout layout,
+                        PixelFormat format,
+                        MappedFile mapping);
+
+        auto load(std::size_t index) const noexcept -> Color;
+        auto store(std::size_t index, const Color& color) noexcept -> void;
+        auto pixelAt(std::size_t index) const noexcept -> Color;
+        auto pixelAt(std::size_t index) noexcept -> PixelRef;
+        auto fill(const Color& color) noexcept -> void;
+
+        auto positionOf(std::size_t index) const noexcept -> Position;
+        auto advance(Position& position) const noexcept -> void;
+        auto row(std::size_t y, Color* scratch) const noexcept -> const Color*;
+
         auto coordToIndex(std::size_t x, std::size_t y) const -> std::size_t;
-        auto writePpmHeader(std::ofstream& file) const -> void;
-        auto writePpmContent(std::ofstream& file) const -> void;
-        auto scaleColor(float color) const -> int;
-        auto writePixelToFile(std::ostringstream& file, const Color& pixel) const -> void;
-        auto splitLineIfNeeded(std::ostringstream& line) const -> void;
+        auto uncheckedIndex(std::size_t x, std::size_t y) const noexcept -> std::size_t;
+        auto save(const std::filesystem::path& filePath,
+                  PpmFormat format,
+                  const Quantization& quantization,
+                  ThreadPool* pool) const -> void;
+        auto writePlainPpm(std::ofstream& file, const Quantization& quantization, ThreadPool* pool) const -> void;
+        auto writeBinaryPpm(std::ofstream& file,
+                            PpmFormat format,
+                            const Quantization& quantization,
+                            ThreadPool* pool) const -> void;
+        auto encodePlainRow(std::size_t y, const Quantization& quantization, char* out) const -> std::size_t;
 
         const std::size_t _width;
         const std::size_t _height;
-        std::vector<Color> _canvas;
+        const CanvasLayout _layout;
+        const PixelFormat _format;
+        // log2 of the tile edge, 0 when row major
+        const std::size_t _tileShift;
+        const std::size_t _tileColumns;
+        const std::size_t _storageSize;
+        std::vector<std::byte, AlignedAllocator<std::byte, 64>> _canvas;
+        MappedFile _mapping;
+        // into _canvas, or past the header of the mapped file
+        std::byte* _pixels;
+};
+
+template<typename CanvasT, typename ColorT>
+class Canvas::StorageIterator
+{
+    public:
+        // pixels are handed out by value, so this is an input iterator
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Canvas::Pixel<ColorT>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = Canvas::Pixel<ColorT>;
+
+        StorageIterator(CanvasT& canvas, std::size_t index) noexcept:
+            _canvas{&canvas},
+            _position{canvas.positionOf(index)}
+        {}
+
+        auto operator*() const noexcept -> Canvas::Pixel<ColorT>
+        {
+            return {_position.x, _position.y, _position.index, _canvas->pixelAt(_position.index)};
+        }
+
+        auto operator++() noexcept -> StorageIterator&
+        {
+            _canvas->advance(_position);
+            return *this;
+        }
+
+        auto operator++(int) noexcept -> StorageIterator
+        {
+            auto previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        auto operator==(const StorageIterator& other) const noexcept -> bool
+        {
+            return _position.index == other._position.index;
+        }
+
+        auto operator!=(const StorageIterator& other) const noexcept -> bool
+        {
+            return !(*this == other);
+        }
+
+    private:
+        CanvasT* _canvas;
+        Position _position;
 };
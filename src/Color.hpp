@@ -1,29 +1,92 @@
 #pragma once
 
+#include "Simd.hpp"
 #include "Utilities.hpp"
+
 #include <array>
 #include <ostream>
 
+// Arithmetic is inline and works on the lanes in registers, so a chained
+// expression like a*s + b*(1 - s) compiles to one SIMD operation per
+// operator, without calls or temporaries in memory. There are no
+// expression templates: a Color is one 16 byte register, so deferring the
+// evaluation would save nothing the inlined operators do not already.
 class Color
 {
     public:
         Color() = default;
-        explicit Color(float r, float g, float b);
-
-        auto operator+=(const Color& rhs) -> Color&;
-        auto operator+(const Color& rhs) const -> Color;
-        auto operator-=(const Color& rhs) -> Color&;
-        auto operator-(const Color& rhs) const -> Color;
-        auto operator*=(const Color& rhs) -> Color&;
-        auto operator*(const Color& rhs) -> Color;
-        auto operator*=(float scalar) -> Color&;
-        auto operator*(float scalar) const -> Color;
-        auto r() const -> const float&;
-        auto g() const -> const float&;
-        auto b() const -> const float&;
+        explicit Color(float r, float g, float b) noexcept:
+            _rgb{r, g, b, 0.f}
+        {}
+
+        auto operator+=(const Color& rhs) noexcept -> Color&
+        {
+            return *this = *this + rhs;
+        }
+
+        auto operator+(const Color& rhs) const noexcept -> Color
+        {
+            return Color{simd::add(lanes(), rhs.lanes())};
+        }
+
+        auto operator-=(const Color& rhs) noexcept -> Color&
+        {
+            return *this = *this - rhs;
+        }
+
+        auto operator-(const Color& rhs) const noexcept -> Color
+        {
+            return Color{simd::sub(lanes(), rhs.lanes())};
+        }
+
+        auto operator*=(const Color& rhs) noexcept -> Color&
+        {
+            return *this = *this*rhs;
+        }
+
+        auto operator*(const Color& rhs) const noexcept -> Color
+        {
+            return Color{simd::mul(lanes(), rhs.lanes())};
+        }
+
+        auto operator*=(float scalar) noexcept -> Color&
+        {
+            return *this = *this*scalar;
+        }
+
+        auto operator*(float scalar) const noexcept -> Color
+        {
+            return Color{simd::mul(lanes(), simd::broadcast(scalar))};
+        }
+
+        auto r() const noexcept -> const float&
+        {
+            return _rgb[0];
+        }
+
+        auto g() const noexcept -> const float&
+        {
+            return _rgb[1];
+        }
+
+        auto b() const noexcept -> const float&
+        {
+            return _rgb[2];
+        }
 
     private:
-        std::array<float, 3> _rgb{};
+        explicit Color(simd::Float4 lanes) noexcept
+        {
+            simd::store(_rgb.data(), lanes);
+        }
+
+        auto lanes() const noexcept -> simd::Float4
+        {
+            return simd::load(_rgb.data());
+        }
+
+        // padded to 4 lanes (last one always 0) so channel math maps onto simd
+        alignas(16) std::array<float, 4> _rgb{};
 };
 
 inline auto operator==(const Color& lhs, const Color& rhs)
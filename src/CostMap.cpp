@@ -0,0 +1,131 @@
+#include "CostMap.hpp"
+#include "Canvas.hpp"
+#include "Color.hpp"
+#include "PlaneFile.hpp"
+
+#include <algorithm>
+#include <array>
+#include <string>
+
+namespace
+{
+constexpr planefile::Magic costMagic{'R', 'T', 'C', 'O', 'S', 'T', 'S', '\0'};
+
+constexpr std::size_t pixelBytes{2*sizeof(std::uint32_t) + sizeof(std::uint64_t)};
+
+const std::array<Color, 5> heatColors{Color{0.f, 0.f, 0.f},
+                                      Color{0.1f, 0.1f, 0.8f},
+                                      Color{0.9f, 0.1f, 0.1f},
+                                      Color{1.f, 0.9f, 0.f},
+                                      Color{1.f, 1.f, 1.f}};
+
+constexpr std::array<const char*, 3> metricNames{"sphere_tests", "bvh_nodes", "cycles"};
+
+// position in [0, 1] on the color scale
+auto heatColor(float position) noexcept -> Color
+{
+    const auto scaled = std::min(std::max(position, 0.f), 1.f)*static_cast<float>(heatColors.size() - 1);
+    const auto index = std::min(static_cast<std::size_t>(scaled), heatColors.size() - 2);
+    const auto fraction = scaled - static_cast<float>(index);
+    return heatColors[index]*(1.f - fraction) + heatColors[index + 1]*fraction;
+}
+}
+
+CostMap::CostMap(std::size_t width, std::size_t height):
+    _width{width},
+    _height{height},
+    _costs(width*height)
+{}
+
+auto CostMap::load(const std::filesystem::path& filePath) -> CostMap
+{
+    planefile::Reader file{filePath, costMagic, pixelBytes, "cost map"};
+    CostMap costs{file.width(), file.height()};
+    file.plane<std::uint32_t>(costs._costs, [](auto& cost, auto value) { cost.sphereTests = value; });
+    file.plane<std::uint32_t>(costs._costs, [](auto& cost, auto value) { cost.bvhNodes = value; });
+    file.plane<std::uint64_t>(costs._costs, [](auto& cost, auto value) { cost.cycles = value; });
+    return costs;
+}
+
+auto CostMap::save(const std::filesystem::path& filePath) const -> void
+{
+    planefile::Writer file{costMagic, _width, _height, pixelBytes};
+    file.plane<std::uint32_t>(_costs, [](const auto& cost) { return cost.sphereTests; });
+    file.plane<std::uint32_t>(_costs, [](const auto& cost) { return cost.bvhNodes; });
+    file.plane<std::uint64_t>(_costs, [](const auto& cost) { return cost.cycles; });
+    file.save(filePath, "cost map");
+}
+
+auto CostMap::saveBeside(const std::filesystem::path& imagePath) const -> void
+{
+    const auto stem = imagePath.parent_path()/imagePath.stem();
+    for (std::size_t metric{0}; metric < metricNames.size(); ++metric) {
+        auto heatmapPath = stem;
+        heatmapPath += std::string{"_"} + metricNames[metric] + ".ppm";
+        heatmap(static_cast<CostMetric>(metric)).saveToFile(heatmapPath, PpmFormat::binary8);
+    }
+    auto rawPath = stem;
+    rawPath += ".costs";
+    save(rawPath);
+}
+
+auto CostMap::width() const noexcept -> std::size_t
+{
+    return _width;
+}
+
+auto CostMap::height() const noexcept -> std::size_t
+{
+    return _height;
+}
+
+auto CostMap::cost(std::size_t x, std::size_t y) const noexcept -> const PixelCost&
+{
+    return _costs[y*_width + x];
+}
+
+auto CostMap::set(std::size_t x, std::size_t y, const PixelCost& cost) noexcept -> void
+{
+    _costs[y*_width + x] = cost;
+}
+
+auto CostMap::value(std::size_t x, std::size_t y, CostMetric metric) const noexcept -> std::uint64_t
+{
+    const auto& pixel = cost(x, y);
+    switch (metric) {
+    case CostMetric::sphereTests:
+        return pixel.sphereTests;
+    case CostMetric::bvhNodes:
+        return pixel.bvhNodes;
+    default:
+        return pixel.cycles;
+    }
+}
+
+auto CostMap::heatmap(CostMetric metric) const -> Canvas
+{
+    Canvas canvas{_width, _height};
+    if (_costs.empty()) {
+        return canvas;
+    }
+    std::vector<std::uint64_t> values;
+    values.reserve(_costs.size());
+    for (std::size_t y{0}; y < _height; ++y) {
+        for (std::size_t x{0}; x < _width; ++x) {
+            values.push_back(value(x, y, metric));
+        }
+    }
+    auto sorted = values;
+    const auto percentile = sorted.begin() + static_cast<std::ptrdiff_t>((sorted.size() - 1)*99/100);
+    std::nth_element(sorted.begin(), percentile, sorted.end());
+    const auto top = *percentile != 0 ? *percentile : *std::max_element(values.begin(), values.end());
+    if (top == 0) {
+        return canvas;
+    }
+    for (std::size_t y{0}; y < _height; ++y) {
+        for (std::size_t x{0}; x < _width; ++x) {
+            canvas(x, y) = heatColor(static_cast<float>(values[y*_width + x])/static_cast<float>(top));
+        }
+    }
+    return canvas;
+}
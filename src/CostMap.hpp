@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+class Canvas;
+
+// What rendering one pixel took.
+struct PixelCost
+{
+    std::uint32_t sphereTests{0};
+    std::uint32_t bvhNodes{0};
+    // time stamp counter ticks on x86, nanoseconds elsewhere, spent
+    // intersecting the pixel's ray with the scene
+    std::uint64_t cycles{0};
+};
+
+enum class CostMetric
+{
+    sphereTests,
+    bvhNodes,
+    cycles
+};
+
+// Cost of every pixel of a render, row by row, to find the regions of a
+// scene that are expensive to trace. The raw file is a header ("RTCOSTS",
+// a zero byte, width and height as 64 bit integers) followed by planes of
+// the sphere tests and BVH nodes (32 bit) and cycles (64 bit) of every
+// pixel, all in native byte order.
+class CostMap
+{
+    public:
+        explicit CostMap(std::size_t width, std::size_t height);
+
+        // throws unless the file is a complete cost map
+        static auto load(const std::filesystem::path& filePath) -> CostMap;
+        auto save(const std::filesystem::path& filePath) const -> void;
+        // The heatmap of every metric and the raw file next to an image:
+        // <stem>_sphere_tests.ppm, <stem>_bvh_nodes.ppm, <stem>_cycles.ppm
+        // and <stem>.costs.
+        auto saveBeside(const std::filesystem::path& imagePath) const -> void;
+
+        auto width() const noexcept -> std::size_t;
+        auto height() const noexcept -> std::size_t;
+        auto cost(std::size_t x, std::size_t y) const noexcept -> const PixelCost&;
+        auto set(std::size_t x, std::size_t y, const PixelCost& cost) noexcept -> void;
+        auto value(std::size_t x, std::size_t y, CostMetric metric) const noexcept -> std::uint64_t;
+        // False colors from black for no cost through blue, red and yellow
+        // to white, reached at the 99th percentile of the metric so a few
+        // outliers (interrupts, for cycles) do not darken the rest.
+        auto heatmap(CostMetric metric) const -> Canvas;
+
+    private:
+        std::size_t _width;
+        std::size_t _height;
+        std::vector<PixelCost> _costs;
+};
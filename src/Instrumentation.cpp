@@ -0,0 +1,223 @@
+#include "Instrumentation.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+
+namespace instrument
+{
+namespace
+{
+constexpr std::array<const char*, phaseCount> phaseNames{
+    "render", "ray generation", "intersection", "shading", "bvh build", "save"};
+constexpr std::array<const char*, counterCount> counterNames{"rays", "hits", "sphere tests", "bvh nodes"};
+// the same in JSON
+constexpr std::array<const char*, phaseCount> phaseKeys{
+    "render", "ray_generation", "intersection", "shading", "bvh_build", "save"};
+constexpr std::array<const char*, counterCount> counterKeys{"rays", "hits", "sphere_tests", "bvh_nodes"};
+constexpr std::array<const char*, hardwareEventCount> eventKeys{
+    "cycles", "instructions", "cache_misses", "branch_misses"};
+
+constexpr std::array<Phase, 3> pixelPhases{Phase::rayGeneration, Phase::intersection, Phase::shading};
+
+auto ratio(double numerator, std::uint64_t denominator) -> double
+{
+    return denominator == 0 ? 0.0 : numerator/static_cast<double>(denominator);
+}
+
+// ", \"hardware\": ..." with the events of every phase, null for events
+// nobody counted and for all of them without counters
+auto hardwareJson(const Report& report) -> std::string
+{
+    if (std::find(report.measured.begin(), report.measured.end(), true) == report.measured.end()) {
+        return ", \"hardware\": null";
+    }
+    std::string json{", \"hardware\": {"};
+    char value[64];
+    for (std::size_t i{0}; i < phaseCount; ++i) {
+        std::snprintf(value, sizeof(value), "%s\"%s\": {", i == 0 ? "" : ", ", phaseKeys[i]);
+        json += value;
+        for (std::size_t event{0}; event < hardwareEventCount; ++event) {
+            if (report.measured[event]) {
+                std::snprintf(value, sizeof(value), "%s\"%s\": %llu", event == 0 ? "" : ", ", eventKeys[event],
+                              static_cast<unsigned long long>(report.events[i][event]));
+            } else {
+                std::snprintf(value, sizeof(value), "%s\"%s\": null", event == 0 ? "" : ", ", eventKeys[event]);
+            }
+            json += value;
+        }
+        json += '}';
+    }
+    return json + "}";
+}
+
+#ifdef RAY_TRACER_INSTRUMENT
+// records outlive their threads, so counts of finished threads still merge
+struct Registry
+{
+    std::mutex mutex;
+    std::deque<detail::ThreadRecord> records;
+};
+
+auto registry() -> Registry&
+{
+    static Registry instance;
+    return instance;
+}
+#endif
+}
+
+auto Report::count(Counter counter) const noexcept -> std::uint64_t
+{
+    return counts[static_cast<std::size_t>(counter)];
+}
+
+auto Report::seconds(Phase phase) const noexcept -> double
+{
+    return static_cast<double>(nanoseconds[static_cast<std::size_t>(phase)])*1e-9;
+}
+
+auto Report::hitRate() const noexcept -> double
+{
+    return ratio(static_cast<double>(count(Counter::hits)), count(Counter::rays));
+}
+
+auto Report::event(Phase phase, HardwareEvent event) const noexcept -> std::uint64_t
+{
+    return events[static_cast<std::size_t>(phase)][static_cast<std::size_t>(event)];
+}
+
+auto Report::instructionsPerCycle(Phase phase) const noexcept -> double
+{
+    return ratio(static_cast<double>(event(phase, HardwareEvent::instructions)), event(phase, HardwareEvent::cycles));
+}
+
+#ifdef RAY_TRACER_INSTRUMENT
+auto detail::registerThread() -> ThreadRecord*
+{
+    auto& instance = registry();
+    const std::lock_guard lock{instance.mutex};
+    return &instance.records.emplace_back();
+}
+#endif
+
+auto collect() -> Report
+{
+    Report report;
+#ifdef RAY_TRACER_INSTRUMENT
+    auto& instance = registry();
+    const std::lock_guard lock{instance.mutex};
+    for (auto& record: instance.records) {
+        for (std::size_t i{0}; i < counterCount; ++i) {
+            report.counts[i] += record.counts[i].exchange(0, std::memory_order_relaxed);
+        }
+        for (std::size_t i{0}; i < phaseCount; ++i) {
+            report.nanoseconds[i] += record.nanoseconds[i].exchange(0, std::memory_order_relaxed);
+        }
+#ifdef RAY_TRACER_PERF_COUNTERS
+        for (std::size_t i{0}; i < hardwareEventCount; ++i) {
+            report.measured[i] = report.measured[i] || record.group.available(static_cast<HardwareEvent>(i));
+            for (std::size_t phase{0}; phase < phaseCount; ++phase) {
+                report.events[phase][i] += record.events[phase][i].exchange(0, std::memory_order_relaxed);
+            }
+        }
+#endif
+    }
+#endif
+    return report;
+}
+
+auto summary(const Report& report) -> std::string
+{
+    std::uint64_t pixelNanoseconds{0};
+    for (const auto phase: pixelPhases) {
+        pixelNanoseconds += report.nanoseconds[static_cast<std::size_t>(phase)];
+    }
+    std::string text;
+    char line[128];
+    for (std::size_t i{0}; i < phaseCount; ++i) {
+        const auto phase = static_cast<Phase>(i);
+        std::snprintf(line, sizeof(line), "%-16s %12.6f s", phaseNames[i], report.seconds(phase));
+        text += line;
+        if (phase == Phase::rayGeneration || phase == Phase::intersection || phase == Phase::shading) {
+            std::snprintf(line, sizeof(line), " %6.1f%%",
+                          100.0*ratio(static_cast<double>(report.nanoseconds[i]), pixelNanoseconds));
+            text += line;
+        }
+        text += '\n';
+    }
+    for (std::size_t i{0}; i < counterCount; ++i) {
+        std::snprintf(line, sizeof(line), "%-16s %14llu", counterNames[i],
+                      static_cast<unsigned long long>(report.counts[i]));
+        text += line;
+        const auto counter = static_cast<Counter>(i);
+        if (counter == Counter::hits) {
+            std::snprintf(line, sizeof(line), " %6.1f%%", 100.0*report.hitRate());
+            text += line;
+        } else if (counter != Counter::rays) {
+            std::snprintf(line, sizeof(line), " %8.2f per ray",
+                          ratio(static_cast<double>(report.counts[i]), report.count(Counter::rays)));
+            text += line;
+        }
+        text += '\n';
+    }
+    const auto renderSeconds = report.seconds(Phase::render);
+    if (renderSeconds > 0.0) {
+        std::snprintf(line, sizeof(line), "%-16s %14.0f\n", "rays/s",
+                      static_cast<double>(report.count(Counter::rays))/renderSeconds);
+        text += line;
+    }
+    if (!hardwareCounters()) {
+        return text;
+    }
+    if (std::find(report.measured.begin(), report.measured.end(), true) == report.measured.end()) {
+        return text + "hardware counters unavailable, times only\n";
+    }
+    std::snprintf(line, sizeof(line), "%-16s %14s %14s %6s %14s %14s\n", "hardware", "cycles", "instructions",
+                  "IPC", "cache misses", "branch misses");
+    text += line;
+    for (std::size_t i{0}; i < phaseCount; ++i) {
+        const auto phase = static_cast<Phase>(i);
+        std::snprintf(line, sizeof(line), "%-16s", phaseNames[i]);
+        text += line;
+        for (std::size_t event{0}; event < hardwareEventCount; ++event) {
+            if (report.measured[event]) {
+                std::snprintf(line, sizeof(line), " %14llu", static_cast<unsigned long long>(report.events[i][event]));
+            } else {
+                std::snprintf(line, sizeof(line), " %14s", "-");
+            }
+            text += line;
+            if (static_cast<HardwareEvent>(event) == HardwareEvent::instructions) {
+                std::snprintf(line, sizeof(line), " %6.2f", report.instructionsPerCycle(phase));
+                text += line;
+            }
+        }
+        text += '\n';
+    }
+    return text;
+}
+
+auto toJson(const Report& report) -> std::string
+{
+    std::string json{"{\"seconds\": {"};
+    char value[64];
+    for (std::size_t i{0}; i < phaseCount; ++i) {
+        std::snprintf(value, sizeof(value), "%s\"%s\": %.9f", i == 0 ? "" : ", ", phaseKeys[i],
+                      report.seconds(static_cast<Phase>(i)));
+        json += value;
+    }
+    json += "}, \"counts\": {";
+    for (std::size_t i{0}; i < counterCount; ++i) {
+        std::snprintf(value, sizeof(value), "%s\"%s\": %llu", i == 0 ? "" : ", ", counterKeys[i],
+                      static_cast<unsigned long long>(report.counts[i]));
+        json += value;
+    }
+    std::snprintf(value, sizeof(value), "}, \"hit_rate\": %.6f", report.hitRate());
+    json += value;
+    if (hardwareCounters()) {
+        json += hardwareJson(report);
+    }
+    return json + "}";
+}
+}
@@ -0,0 +1,214 @@
+#pragma once
+
+#include "PerfEvents.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#ifdef RAY_TRACER_INSTRUMENT
+#include <atomic>
+#include <chrono>
+#endif
+
+// Ray counts, intersection test counts and phase times of the render
+// pipeline. Compiled in by the INSTRUMENTATION option, which defines
+// RAY_TRACER_INSTRUMENT; otherwise the hooks below compile to nothing and
+// collect() reports zeros. Each thread counts into a record
+// of its own without locking, and collect() merges and clears the records
+// of all threads, so it belongs between frames, not during one.
+//
+// The PERF_COUNTERS option (RAY_TRACER_PERF_COUNTERS, which implies
+// RAY_TRACER_INSTRUMENT) also counts hardware events per phase: every
+// thread opens a PerfEventGroup and phases add up its differences. Where
+// the counters cannot be opened the report has times only.
+namespace instrument
+{
+enum class Phase
+{
+    // whole Renderer calls, on the calling thread
+    render,
+    // per pixel work of all render threads, summed
+    rayGeneration,
+    intersection,
+    shading,
+    bvhBuild,
+    save
+};
+
+enum class Counter
+{
+    rays,
+    hits,
+    // ray against sphere, a packet counting once per lane
+    sphereTests,
+    bvhNodes
+};
+
+constexpr std::size_t phaseCount{6};
+constexpr std::size_t counterCount{4};
+
+struct Report
+{
+    std::array<std::uint64_t, counterCount> counts{};
+    std::array<std::uint64_t, phaseCount> nanoseconds{};
+    std::array<EventCounts, phaseCount> events{};
+    // events at least one thread could count
+    std::array<bool, hardwareEventCount> measured{};
+
+    auto count(Counter counter) const noexcept -> std::uint64_t;
+    auto seconds(Phase phase) const noexcept -> double;
+    auto hitRate() const noexcept -> double;
+    auto event(Phase phase, HardwareEvent event) const noexcept -> std::uint64_t;
+    auto instructionsPerCycle(Phase phase) const noexcept -> double;
+};
+
+constexpr auto enabled() noexcept -> bool
+{
+#ifdef RAY_TRACER_INSTRUMENT
+    return true;
+#else
+    return false;
+#endif
+}
+
+constexpr auto hardwareCounters() noexcept -> bool
+{
+#ifdef RAY_TRACER_PERF_COUNTERS
+    return true;
+#else
+    return false;
+#endif
+}
+
+auto collect() -> Report;
+// phase times with their share of the per pixel work, then the counters
+auto summary(const Report& report) -> std::string;
+auto toJson(const Report& report) -> std::string;
+
+namespace detail
+{
+// phase that allocations of this thread are attributed to in builds with
+// ALLOCATION_TRACKING, phaseCount outside of every phase
+inline thread_local std::size_t currentPhase{phaseCount};
+
+#ifdef RAY_TRACER_INSTRUMENT
+// Written only by its thread. The relaxed load and store compile to a
+// plain add, but keep collect() from racing in the language sense.
+struct ThreadRecord
+{
+    std::array<std::atomic<std::uint64_t>, counterCount> counts;
+    std::array<std::atomic<std::uint64_t>, phaseCount> nanoseconds;
+#ifdef RAY_TRACER_PERF_COUNTERS
+    // opened by registerThread() on the thread itself
+    PerfEventGroup group;
+    std::array<std::array<std::atomic<std::uint64_t>, hardwareEventCount>, phaseCount> events;
+#endif
+};
+
+auto registerThread() -> ThreadRecord*;
+
+inline thread_local ThreadRecord* record{nullptr};
+
+inline auto local() -> ThreadRecord&
+{
+    if (record == nullptr) {
+        record = registerThread();
+    }
+    return *record;
+}
+
+inline auto add(std::atomic<std::uint64_t>& value, std::uint64_t amount) noexcept -> void
+{
+    value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+inline auto now() noexcept -> std::uint64_t
+{
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+#endif
+}
+
+#ifdef RAY_TRACER_INSTRUMENT
+inline auto count(Counter counter, std::uint64_t amount = 1) -> void
+{
+    detail::add(detail::local().counts[static_cast<std::size_t>(counter)], amount);
+}
+#else
+inline auto count(Counter, std::uint64_t = 1) noexcept -> void {}
+#endif
+
+// Adds its lifetime to a phase. enter() splits a stretch of work into
+// consecutive phases: it ends the current one and starts the next.
+class ScopedPhase
+{
+    public:
+        explicit ScopedPhase(Phase phase) noexcept:
+            _phase{phase}
+        {
+#ifdef RAY_TRACER_INSTRUMENT
+            _start = detail::now();
+#endif
+#ifdef RAY_TRACER_PERF_COUNTERS
+            _events = detail::local().group.read();
+#endif
+#ifdef RAY_TRACER_TRACK_ALLOCATIONS
+            _outer = detail::currentPhase;
+            detail::currentPhase = static_cast<std::size_t>(phase);
+#endif
+        }
+
+        ~ScopedPhase()
+        {
+            end();
+#ifdef RAY_TRACER_TRACK_ALLOCATIONS
+            detail::currentPhase = _outer;
+#endif
+        }
+
+        ScopedPhase(const ScopedPhase&) = delete;
+        auto operator=(const ScopedPhase&) -> ScopedPhase& = delete;
+
+        auto enter(Phase phase) noexcept -> void
+        {
+            end();
+            _phase = phase;
+#ifdef RAY_TRACER_TRACK_ALLOCATIONS
+            detail::currentPhase = static_cast<std::size_t>(phase);
+#endif
+        }
+
+    private:
+        auto end() noexcept -> void
+        {
+#ifdef RAY_TRACER_INSTRUMENT
+            auto& record = detail::local();
+            const auto phase = static_cast<std::size_t>(_phase);
+            const auto time = detail::now();
+            detail::add(record.nanoseconds[phase], time - _start);
+            _start = time;
+#endif
+#ifdef RAY_TRACER_PERF_COUNTERS
+            const auto events = record.group.read();
+            for (std::size_t i{0}; i < hardwareEventCount; ++i) {
+                detail::add(record.events[phase][i], events[i] - _events[i]);
+            }
+            _events = events;
+#endif
+        }
+
+        Phase _phase;
+#ifdef RAY_TRACER_INSTRUMENT
+        std::uint64_t _start;
+#endif
+#ifdef RAY_TRACER_PERF_COUNTERS
+        EventCounts _events;
+#endif
+#ifdef RAY_TRACER_TRACK_ALLOCATIONS
+        std::size_t _outer;
+#endif
+};
+}
@@ -0,0 +1,54 @@
+#include "Intersection.hpp"
+#include "Utilities.hpp"
+
+auto Intersections::add(const Intersection& intersection) -> void
+{
+    if (_size < inlineCapacity) {
+        _inline[_size] = intersection;
+    } else {
+        _overflow.push_back(intersection);
+    }
+    ++_size;
+}
+
+auto Intersections::add(const ObjectIntersections& intersections) -> void
+{
+    for (const auto& intersection: intersections) {
+        add(intersection);
+    }
+}
+
+auto Intersections::clear() noexcept -> void
+{
+    _overflow.clear();
+    _size = 0;
+}
+
+auto Intersections::size() const noexcept -> std::size_t
+{
+    return _size;
+}
+
+auto Intersections::empty() const noexcept -> bool
+{
+    return _size == 0;
+}
+
+auto Intersections::operator[](std::size_t index) const noexcept -> const Intersection&
+{
+    RAY_TRACER_ASSERT_INDEX(index < _size);
+    return index < inlineCapacity ? _inline[index] : _overflow[index - inlineCapacity];
+}
+
+// nearest intersection in front of the ray origin, found in a single pass
+auto Intersections::hit() const noexcept -> std::optional<Intersection>
+{
+    std::optional<Intersection> nearest;
+    for (std::size_t i{0}; i < _size; ++i) {
+        const auto& candidate = (*this)[i];
+        if (candidate.t >= 0.f && (!nearest || candidate.t < nearest->t)) {
+            nearest = candidate;
+        }
+    }
+    return nearest;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "Utilities.hpp"
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+struct Intersection
+{
+    float t;
+    std::size_t object;
+};
+
+inline auto operator==(const Intersection& lhs, const Intersection& rhs)
+{
+    return lhs.t == rhs.t && lhs.object == rhs.object;
+}
+
+// Intersections of a ray with a single object, stored inline; convex shapes
+// are crossed at most twice.
+class ObjectIntersections
+{
+    public:
+        static constexpr std::size_t capacity{2};
+
+        auto add(float t, std::size_t object) noexcept -> void
+        {
+            RAY_TRACER_ASSERT_INDEX(_size < capacity);
+            _hits[_size++] = Intersection{t, object};
+        }
+
+        auto size() const noexcept -> std::size_t
+        {
+            return _size;
+        }
+
+        auto empty() const noexcept -> bool
+        {
+            return _size == 0;
+        }
+
+        auto operator[](std::size_t index) const noexcept -> const Intersection&
+        {
+            RAY_TRACER_ASSERT_INDEX(index < _size);
+            return _hits[index];
+        }
+
+        auto begin() const noexcept
+        {
+            return _hits.begin();
+        }
+
+        auto end() const noexcept
+        {
+            return _hits.begin() + static_cast<std::ptrdiff_t>(_size);
+        }
+
+    private:
+        std::array<Intersection, capacity> _hits{};
+        std::size_t _size{0};
+};
+
+// Intersections collected over all objects of a scene. The first
+// inlineCapacity records live inside the object, the rest spill to a
+// vector whose capacity is kept across clear(), so a reused instance does
+// not touch the heap.
+class Intersections
+{
+    public:
+        static constexpr std::size_t inlineCapacity{16};
+
+        auto add(const Intersection& intersection) -> void;
+        auto add(const ObjectIntersections& intersections) -> void;
+        auto clear() noexcept -> void;
+        auto size() const noexcept -> std::size_t;
+        auto empty() const noexcept -> bool;
+        auto operator[](std::size_t index) const noexcept -> const Intersection&;
+        auto hit() const noexcept -> std::optional<Intersection>;
+
+    private:
+        std::array<Intersection, inlineCapacity> _inline{};
+        std::vector<Intersection> _overflow;
+        std::size_t _size{0};
+};
@@ -0,0 +1,126 @@
+#include "MappedFile.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+[[noreturn]] auto fail(const std::string& what, const std::filesystem::path& filePath) -> void
+{
+    throw std::runtime_error(what + " " + filePath.string() + ": " + std::strerror(errno));
+}
+
+// closes the descriptor once mapped; the mapping keeps the file open
+class Descriptor
+{
+    public:
+        explicit Descriptor(int descriptor): _descriptor{descriptor} {}
+        ~Descriptor() { ::close(_descriptor); }
+        Descriptor(const Descriptor&) = delete;
+        auto operator=(const Descriptor&) -> Descriptor& = delete;
+
+        auto get() const noexcept -> int { return _descriptor; }
+
+    private:
+        int _descriptor;
+};
+}
+
+MappedFile::~MappedFile()
+{
+    release();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept:
+    _data{std::exchange(other._data, nullptr)},
+    _size{std::exchange(other._size, 0)}
+{}
+
+auto MappedFile::operator=(MappedFile&& other) noexcept -> MappedFile&
+{
+    if (this != &other) {
+        release();
+        _data = std::exchange(other._data, nullptr);
+        _size = std::exchange(other._size, 0);
+    }
+    return *this;
+}
+
+auto MappedFile::create(const std::filesystem::path& filePath, std::size_t size) -> MappedFile
+{
+    const Descriptor file{::open(filePath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644)};
+    if (file.get() < 0) {
+        fail("Cannot open/create file", filePath);
+    }
+    // Disk space is reserved up front: a page of a sparse file that finds
+    // the disk full when written through the mapping raises SIGBUS.
+    if (size > 0) {
+        if (const auto error = ::posix_fallocate(file.get(), 0, static_cast<off_t>(size)); error != 0) {
+            errno = error;
+            fail("Cannot allocate file", filePath);
+        }
+    }
+    return map(file.get(), size);
+}
+
+auto MappedFile::open(const std::filesystem::path& filePath) -> MappedFile
+{
+    const Descriptor file{::open(filePath.c_str(), O_RDWR)};
+    if (file.get() < 0) {
+        fail("Cannot open file", filePath);
+    }
+    struct stat status{};
+    if (::fstat(file.get(), &status) != 0) {
+        fail("Cannot read size of file", filePath);
+    }
+    return map(file.get(), static_cast<std::size_t>(status.st_size));
+}
+
+auto MappedFile::map(int descriptor, std::size_t size) -> MappedFile
+{
+    MappedFile mapping;
+    if (size == 0) {
+        return mapping;
+    }
+    auto* const data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+    if (data == MAP_FAILED) {
+        throw std::runtime_error(std::string("Cannot map file: ") + std::strerror(errno));
+    }
+    mapping._data = static_cast<std::byte*>(data);
+    mapping._size = size;
+    return mapping;
+}
+
+auto MappedFile::data() const noexcept -> std::byte*
+{
+    return _data;
+}
+
+auto MappedFile::size() const noexcept -> std::size_t
+{
+    return _size;
+}
+
+auto MappedFile::flush() const -> void
+{
+    if (_data && ::msync(_data, _size, MS_SYNC) != 0) {
+        throw std::runtime_error(std::string("Cannot write back mapped file: ") + std::strerror(errno));
+    }
+}
+
+auto MappedFile::release() noexcept -> void
+{
+    if (_data) {
+        ::munmap(_data, _size);
+        _data = nullptr;
+        _size = 0;
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+
+// A whole file mapped read-write into memory. Writes go straight to the
+// page cache and reach the file when the kernel writes the pages back, at
+// the latest on flush() or when the mapping is released.
+class MappedFile
+{
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        auto operator=(const MappedFile&) -> MappedFile& = delete;
+        MappedFile(MappedFile&& other) noexcept;
+        auto operator=(MappedFile&& other) noexcept -> MappedFile&;
+
+        // Creates or truncates the file and resizes it to `size` zero bytes,
+        // with their disk space allocated.
+        static auto create(const std::filesystem::path& filePath, std::size_t size) -> MappedFile;
+        static auto open(const std::filesystem::path& filePath) -> MappedFile;
+
+        auto data() const noexcept -> std::byte*;
+        auto size() const noexcept -> std::size_t;
+        auto flush() const -> void;
+
+    private:
+        static auto map(int descriptor, std::size_t size) -> MappedFile;
+        auto release() noexcept -> void;
+
+        std::byte* _data{nullptr};
+        std::size_t _size{0};
+};
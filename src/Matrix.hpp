@@ -26,32 +26,35 @@ class Matrix
             if (list.size() > size*size) {
                 throw std::runtime_error("Too many elements in initializer list");
             }
-            std::copy(list.begin(), list.end(), _matrix.begin());
+            std::size_t index{0};
+            for (const auto value: list) {
+                _matrix[index++] = value;
+            }
         }
 
-        auto& operator*=(const Matrix<size>& rhs)
+        constexpr auto& operator*=(const Matrix<size>& rhs)
         {
             std::array<float, size*size> tmp{};
             for(unsigned int row{0}; row < size; ++row){
                 for(unsigned int column{0}; column < size; ++column) {
                     for(unsigned int k{0}; k < size; ++k) {
-                        tmp[coordToIndex(row, column)] += at(row, k)*rhs.at(k, column);
+                        tmp[coordToIndex(row, column)] += (*this)(row, k)*rhs(k, column);
                     }
                 }
             }
-            std::copy(tmp.begin(), tmp.end(), _matrix.begin());
+            _matrix = tmp;
             return *this;
         }
 
-        auto& operator/=(float scalar)
+        constexpr auto& operator/=(float scalar)
         {
-            std::for_each(_matrix.begin(),
-                          _matrix.end(),
-                          [scalar](float& el){el/=scalar;});
+            for (auto& el: _matrix) {
+                el /= scalar;
+            }
             return *this;
         }
 
-        auto at(std::size_t row, std::size_t column) const
+        constexpr auto at(std::size_t row, std::size_t column) const
         {
             if (row > size-1 || column > size-1) {
                 throw std::runtime_error("out of bounds");
@@ -59,7 +62,7 @@ class Matrix
             return _matrix[coordToIndex(row, column)];
         }
 
-        auto& at(std::size_t row, std::size_t column)
+        constexpr auto& at(std::size_t row, std::size_t column)
         {
             if (row > size-1 || column > size-1) {
                 throw std::runtime_error("out of bounds");
@@ -67,8 +70,47 @@ class Matrix
             return _matrix[coordToIndex(row, column)];
         }
 
+        constexpr auto operator()(std::size_t row, std::size_t column) const noexcept
+        {
+            RAY_TRACER_ASSERT_INDEX(row < size && column < size);
+            return _matrix[coordToIndex(row, column)];
+        }
+
+        constexpr auto& operator()(std::size_t row, std::size_t column) noexcept
+        {
+            RAY_TRACER_ASSERT_INDEX(row < size && column < size);
+            return _matrix[coordToIndex(row, column)];
+        }
+
+        template<std::size_t row, std::size_t column>
+        constexpr auto get() const noexcept
+        {
+            static_assert(row < size && column < size, "Index out of bounds");
+            return std::get<size*row + column>(_matrix);
+        }
+
+        template<std::size_t row, std::size_t column>
+        constexpr auto& get() noexcept
+        {
+            static_assert(row < size && column < size, "Index out of bounds");
+            return std::get<size*row + column>(_matrix);
+        }
+
+        auto data() const noexcept -> const float*
+        {
+            return _matrix.data();
+        }
+
+        auto data() noexcept -> float*
+        {
+            return _matrix.data();
+        }
+
     private:
-        auto coordToIndex(std::size_t row, std::size_t column) const -> std::size_t;
+        constexpr auto coordToIndex(std::size_t row, std::size_t column) const noexcept -> std::size_t
+        {
+            return size*row + column;
+        }
 
         std::array<float, size*size> _matrix{};
 };
@@ -79,36 +121,30 @@ using Mat2 = Matrix<2>;
 using Mat1 = Matrix<1>;
 
 namespace matrix {
-inline const Mat1 identity1{1.f};
-inline const Mat2 identity2{1.f, 0.f,
-                            0.f, 1.f};
-inline const Mat3 identity3{1.f, 0.f, 0.f,
-                            0.f, 1.f, 0.f,
-                            0.f, 0.f, 1.f};
-inline const Mat4 identity4{1.f, 0.f, 0.f, 0.f,
-                            0.f, 1.f, 0.f, 0.f,
-                            0.f, 0.f, 1.f, 0.f,
-                            0.f, 0.f, 0.f, 1.f};
+inline constexpr Mat1 identity1{1.f};
+inline constexpr Mat2 identity2{1.f, 0.f,
+                                0.f, 1.f};
+inline constexpr Mat3 identity3{1.f, 0.f, 0.f,
+                                0.f, 1.f, 0.f,
+                                0.f, 0.f, 1.f};
+inline constexpr Mat4 identity4{1.f, 0.f, 0.f, 0.f,
+                                0.f, 1.f, 0.f, 0.f,
+                                0.f, 0.f, 1.f, 0.f,
+                                0.f, 0.f, 0.f, 1.f};
 }
 
 template<std::size_t size>
-inline auto indexToCoord(std::size_t index) -> std::pair<std::size_t, std::size_t>
+constexpr auto indexToCoord(std::size_t index) -> std::pair<std::size_t, std::size_t>
 {
     return {index/size, index%size};
 }
 
-template<std::size_t size>
-auto Matrix<size>::coordToIndex(std::size_t row, std::size_t column) const -> std::size_t
-{
-    return size*row + column;
-}
-
 template<std::size_t size>
 inline auto operator==(const Matrix<size>& lhs, const Matrix<size>& rhs)
 {
     for(std::size_t i{0}; i < size*size; ++i) {
         const auto [row, column] = indexToCoord<size>(i);
-        if (!relativelyEqual(lhs.at(row, column), rhs.at(row, column))) {
+        if (!relativelyEqual(lhs(row, column), rhs(row, column))) {
             return false;
         }
     }
@@ -122,50 +158,52 @@ inline auto operator!=(const Matrix<size>& lhs, const Matrix<size>& rhs)
 }
 
 template<std::size_t size>
-inline auto operator*(Matrix<size> lhs, const Matrix<size>& rhs)
+constexpr auto operator*(Matrix<size> lhs, const Matrix<size>& rhs)
 {
     lhs *= rhs;
     return lhs;
 }
 
 template<std::size_t size>
-inline auto operator*(const Matrix<size>& lhs, const Vector<size>& rhs)
+constexpr auto operator*(const Matrix<size>& lhs, const Vector<size>& rhs)
 {
     Vector<size> temp;
     for (std::size_t row{0}; row < size; ++row) {
         for (std::size_t k{0}; k < size; ++k) {
-            temp.at(row) += lhs.at(row, k) * rhs.at(k);
+            temp[row] += lhs(row, k) * rhs[k];
         }
     }
     return temp;
 }
 
 template<std::size_t size>
-inline auto operator*(const Matrix<size>& lhs, const Point<size>& rhs)
+constexpr auto operator*(const Matrix<size>& lhs, const Point<size>& rhs)
 {
     Point<size> temp;
     for (std::size_t row{0}; row < size; ++row) {
         for (std::size_t k{0}; k < size; ++k) {
-            temp.at(row) += lhs.at(row, k) * rhs.at(k);
+            temp[row] += lhs(row, k) * rhs[k];
         }
     }
     return temp;
 }
 
 template<std::size_t size>
-inline auto operator/(Matrix<size> lhs, float scalar)
+constexpr auto operator/(Matrix<size> lhs, float scalar)
 {
     lhs /= scalar;
     return lhs;
 }
 
 template<std::size_t size>
-inline auto transpose(Matrix<size> mat)
+constexpr auto transpose(Matrix<size> mat)
 {
     for (std::size_t row{0}; row < size; ++row) {
         for (std::size_t column{row}; column < size; ++column) {
             if (row != column) {
-                std::swap(mat.at(row, column), mat.at(column, row));
+                const auto tmp = mat(row, column);
+                mat(row, column) = mat(column, row);
+                mat(column, row) = tmp;
             }
         }
     }
@@ -173,23 +211,42 @@ inline auto transpose(Matrix<size> mat)
 }
 
 template<std::size_t size>
-inline auto determinant(const Matrix<size>& mat)
+constexpr auto determinant(const Matrix<size>& mat)
 {
     auto determinant = 0.f;
     for(std::size_t column{0}; column < size; ++column) {
-        determinant += mat.at(0, column) * cofactor(mat, 0, column);
+        determinant += mat(0, column) * cofactor(mat, 0, column);
     }
     return determinant;
 }
 
 template<>
-inline auto determinant(const Matrix<1>& mat)
+constexpr auto determinant(const Matrix<1>& mat)
 {
-    return mat.at(0,0);
+    return mat(0, 0);
+}
+
+// closed form on 2x2 sub-determinants shared by both halves of the matrix
+template<>
+constexpr auto determinant(const Matrix<4>& mat)
+{
+    const auto s0 = mat(0, 0)*mat(1, 1) - mat(0, 1)*mat(1, 0);
+    const auto s1 = mat(0, 0)*mat(1, 2) - mat(0, 2)*mat(1, 0);
+    const auto s2 = mat(0, 0)*mat(1, 3) - mat(0, 3)*mat(1, 0);
+    const auto s3 = mat(0, 1)*mat(1, 2) - mat(0, 2)*mat(1, 1);
+    const auto s4 = mat(0, 1)*mat(1, 3) - mat(0, 3)*mat(1, 1);
+    const auto s5 = mat(0, 2)*mat(1, 3) - mat(0, 3)*mat(1, 2);
+    const auto c0 = mat(2, 0)*mat(3, 1) - mat(2, 1)*mat(3, 0);
+    const auto c1 = mat(2, 0)*mat(3, 2) - mat(2, 2)*mat(3, 0);
+    const auto c2 = mat(2, 0)*mat(3, 3) - mat(2, 3)*mat(3, 0);
+    const auto c3 = mat(2, 1)*mat(3, 2) - mat(2, 2)*mat(3, 1);
+    const auto c4 = mat(2, 1)*mat(3, 3) - mat(2, 3)*mat(3, 1);
+    const auto c5 = mat(2, 2)*mat(3, 3) - mat(2, 3)*mat(3, 2);
+    return s0*c5 - s1*c4 + s2*c3 + s3*c2 - s4*c1 + s5*c0;
 }
 
 template<std::size_t size>
-inline auto submatrix(const Matrix<size>& mat, std::size_t rowToDelete, std::size_t columnToDelete)
+constexpr auto submatrix(const Matrix<size>& mat, std::size_t rowToDelete, std::size_t columnToDelete)
 {
     Matrix<size-1> temp;
     for (std::size_t row{0}; row < size; ++row) {
@@ -197,7 +254,7 @@ inline auto submatrix(const Matrix<size>& mat, std::size_t rowToDelete, std::siz
             if (row != rowToDelete && column != columnToDelete) {
                 const auto rowToInsert = row > rowToDelete ? row-1 : row;
                 const auto columnToInsert = column > columnToDelete ? column-1 : column;
-                temp.at(rowToInsert, columnToInsert) = mat.at(row, column);
+                temp(rowToInsert, columnToInsert) = mat(row, column);
             }
         }
     }
@@ -205,30 +262,30 @@ inline auto submatrix(const Matrix<size>& mat, std::size_t rowToDelete, std::siz
 }
 
 template<std::size_t size>
-inline auto minor(const Matrix<size>& mat, std::size_t row, std::size_t column)
+constexpr auto minor(const Matrix<size>& mat, std::size_t row, std::size_t column)
 {
     return determinant(submatrix(mat, row, column));
 }
 
 template<std::size_t size>
-inline auto cofactor(const Matrix<size>& mat, std::size_t row, std::size_t column)
+constexpr auto cofactor(const Matrix<size>& mat, std::size_t row, std::size_t column)
 {
     return (row+column)&1 ? -minor(mat, row, column) : minor(mat, row, column);
 }
 
 template<std::size_t size>
-inline auto isInvertible(const Matrix<size>& mat)
+constexpr auto isInvertible(const Matrix<size>& mat)
 {
     return determinant(mat) != 0;
 }
 
 template<std::size_t size>
-inline auto inverse(const Matrix<size>& mat)
+constexpr auto inverse(const Matrix<size>& mat)
 {
     Matrix<size> matOfCofactors;
     for (std::size_t row{0}; row < size; ++row) {
         for (std::size_t column{0}; column < size; ++column) {
-            matOfCofactors.at(row, column) = cofactor(mat, row, column);
+            matOfCofactors(row, column) = cofactor(mat, row, column);
         }
     }
     matOfCofactors = transpose(std::move(matOfCofactors));
@@ -236,13 +293,97 @@ inline auto inverse(const Matrix<size>& mat)
     return matOfCofactors;
 }
 
+constexpr auto isAffine(const Matrix<4>& mat)
+{
+    return mat(3, 0) == 0.f && mat(3, 1) == 0.f &&
+           mat(3, 2) == 0.f && mat(3, 3) == 1.f;
+}
+
+// inverse of [A|t] with bottom row 0 0 0 1 is [inv(A)|-inv(A)*t]; only the
+// top three rows of both matrices are touched, so any type indexable with
+// (row, column) works (Mat4 and Affine3)
+template<typename Source, typename Destination>
+constexpr auto invertAffineRows(const Source& mat, Destination& inv) -> void
+{
+    const auto c00 = mat(1, 1)*mat(2, 2) - mat(1, 2)*mat(2, 1);
+    const auto c01 = mat(1, 2)*mat(2, 0) - mat(1, 0)*mat(2, 2);
+    const auto c02 = mat(1, 0)*mat(2, 1) - mat(1, 1)*mat(2, 0);
+    const auto invDet = 1.f/(mat(0, 0)*c00 + mat(0, 1)*c01 + mat(0, 2)*c02);
+
+    inv(0, 0) = c00*invDet;
+    inv(1, 0) = c01*invDet;
+    inv(2, 0) = c02*invDet;
+    inv(0, 1) = (mat(0, 2)*mat(2, 1) - mat(0, 1)*mat(2, 2))*invDet;
+    inv(1, 1) = (mat(0, 0)*mat(2, 2) - mat(0, 2)*mat(2, 0))*invDet;
+    inv(2, 1) = (mat(0, 1)*mat(2, 0) - mat(0, 0)*mat(2, 1))*invDet;
+    inv(0, 2) = (mat(0, 1)*mat(1, 2) - mat(0, 2)*mat(1, 1))*invDet;
+    inv(1, 2) = (mat(0, 2)*mat(1, 0) - mat(0, 0)*mat(1, 2))*invDet;
+    inv(2, 2) = (mat(0, 0)*mat(1, 1) - mat(0, 1)*mat(1, 0))*invDet;
+    for (std::size_t row{0}; row < 3; ++row) {
+        inv(row, 3) = -(inv(row, 0)*mat(0, 3) +
+                        inv(row, 1)*mat(1, 3) +
+                        inv(row, 2)*mat(2, 3));
+    }
+}
+
+constexpr auto affineInverse(const Matrix<4>& mat)
+{
+    Matrix<4> inv;
+    invertAffineRows(mat, inv);
+    inv(3, 3) = 1.f;
+    return inv;
+}
+
+// closed form on 2x2 sub-determinants, each one computed once
+template<>
+constexpr auto inverse(const Matrix<4>& mat)
+{
+    if (isAffine(mat)) {
+        return affineInverse(mat);
+    }
+    const auto s0 = mat(0, 0)*mat(1, 1) - mat(0, 1)*mat(1, 0);
+    const auto s1 = mat(0, 0)*mat(1, 2) - mat(0, 2)*mat(1, 0);
+    const auto s2 = mat(0, 0)*mat(1, 3) - mat(0, 3)*mat(1, 0);
+    const auto s3 = mat(0, 1)*mat(1, 2) - mat(0, 2)*mat(1, 1);
+    const auto s4 = mat(0, 1)*mat(1, 3) - mat(0, 3)*mat(1, 1);
+    const auto s5 = mat(0, 2)*mat(1, 3) - mat(0, 3)*mat(1, 2);
+    const auto c0 = mat(2, 0)*mat(3, 1) - mat(2, 1)*mat(3, 0);
+    const auto c1 = mat(2, 0)*mat(3, 2) - mat(2, 2)*mat(3, 0);
+    const auto c2 = mat(2, 0)*mat(3, 3) - mat(2, 3)*mat(3, 0);
+    const auto c3 = mat(2, 1)*mat(3, 2) - mat(2, 2)*mat(3, 1);
+    const auto c4 = mat(2, 1)*mat(3, 3) - mat(2, 3)*mat(3, 1);
+    const auto c5 = mat(2, 2)*mat(3, 3) - mat(2, 3)*mat(3, 2);
+    const auto invDet = 1.f/(s0*c5 - s1*c4 + s2*c3 + s3*c2 - s4*c1 + s5*c0);
+
+    return Matrix<4>{
+        ( mat(1, 1)*c5 - mat(1, 2)*c4 + mat(1, 3)*c3)*invDet,
+        (-mat(0, 1)*c5 + mat(0, 2)*c4 - mat(0, 3)*c3)*invDet,
+        ( mat(3, 1)*s5 - mat(3, 2)*s4 + mat(3, 3)*s3)*invDet,
+        (-mat(2, 1)*s5 + mat(2, 2)*s4 - mat(2, 3)*s3)*invDet,
+
+        (-mat(1, 0)*c5 + mat(1, 2)*c2 - mat(1, 3)*c1)*invDet,
+        ( mat(0, 0)*c5 - mat(0, 2)*c2 + mat(0, 3)*c1)*invDet,
+        (-mat(3, 0)*s5 + mat(3, 2)*s2 - mat(3, 3)*s1)*invDet,
+        ( mat(2, 0)*s5 - mat(2, 2)*s2 + mat(2, 3)*s1)*invDet,
+
+        ( mat(1, 0)*c4 - mat(1, 1)*c2 + mat(1, 3)*c0)*invDet,
+        (-mat(0, 0)*c4 + mat(0, 1)*c2 - mat(0, 3)*c0)*invDet,
+        ( mat(3, 0)*s4 - mat(3, 1)*s2 + mat(3, 3)*s0)*invDet,
+        (-mat(2, 0)*s4 + mat(2, 1)*s2 - mat(2, 3)*s0)*invDet,
+
+        (-mat(1, 0)*c3 + mat(1, 1)*c1 - mat(1, 2)*c0)*invDet,
+        ( mat(0, 0)*c3 - mat(0, 1)*c1 + mat(0, 2)*c0)*invDet,
+        (-mat(3, 0)*s3 + mat(3, 1)*s1 - mat(3, 2)*s0)*invDet,
+        ( mat(2, 0)*s3 - mat(2, 1)*s1 + mat(2, 2)*s0)*invDet};
+}
+
 template<std::size_t size>
 inline auto operator<<(std::ostream& os, const Matrix<size>& mat) -> std::ostream&
 {
     for (std::size_t row{0}; row < size; ++row) {
         os << "|";
         for(std::size_t column{0}; column < size; ++column) {
-            os << mat.at(row, column) << " ";
+            os << mat(row, column) << " ";
         }
         os << "|\n";
     }
@@ -0,0 +1,96 @@
+#include "PerfEvents.hpp"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#endif
+
+namespace
+{
+#ifdef __linux__
+constexpr std::array<std::uint64_t, hardwareEventCount> configs{PERF_COUNT_HW_CPU_CYCLES,
+                                                                 PERF_COUNT_HW_INSTRUCTIONS,
+                                                                 PERF_COUNT_HW_CACHE_MISSES,
+                                                                 PERF_COUNT_HW_BRANCH_MISSES};
+
+// the first event opened leads the group
+auto openEvent(std::uint64_t config, int leader) noexcept -> int
+{
+    perf_event_attr attributes{};
+    attributes.size = sizeof(attributes);
+    attributes.type = PERF_TYPE_HARDWARE;
+    attributes.config = config;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+    attributes.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, leader, 0));
+}
+#endif
+}
+
+PerfEventGroup::PerfEventGroup() noexcept
+{
+    _fds.fill(-1);
+#ifdef __linux__
+    for (std::size_t i{0}; i < hardwareEventCount; ++i) {
+        _fds[i] = openEvent(configs[i], _opened == 0 ? -1 : _fds[_slots[0]]);
+        if (_fds[i] < 0) {
+            _error = _error == 0 ? errno : _error;
+            continue;
+        }
+        _slots[_opened++] = i;
+    }
+#else
+    _error = -1;
+#endif
+}
+
+PerfEventGroup::~PerfEventGroup()
+{
+#ifdef __linux__
+    // members before the leader
+    for (auto i = _opened; i > 0; --i) {
+        close(_fds[_slots[i - 1]]);
+    }
+#endif
+}
+
+auto PerfEventGroup::available() const noexcept -> bool
+{
+    return _opened > 0;
+}
+
+auto PerfEventGroup::available(HardwareEvent event) const noexcept -> bool
+{
+    return _fds[static_cast<std::size_t>(event)] >= 0;
+}
+
+auto PerfEventGroup::error() const noexcept -> int
+{
+    return _error;
+}
+
+auto PerfEventGroup::read() const noexcept -> EventCounts
+{
+    EventCounts counts{};
+#ifdef __linux__
+    if (_opened == 0) {
+        return counts;
+    }
+    // number of events, time enabled, time running, then the values
+    std::array<std::uint64_t, 3 + hardwareEventCount> buffer{};
+    const auto size = static_cast<long>((3 + _opened)*sizeof(std::uint64_t));
+    if (::read(_fds[_slots[0]], buffer.data(), static_cast<std::size_t>(size)) != size || buffer[2] == 0) {
+        return counts;
+    }
+    const auto scale = static_cast<double>(buffer[1])/static_cast<double>(buffer[2]);
+    for (std::size_t slot{0}; slot < _opened; ++slot) {
+        counts[_slots[slot]] = buffer[1] == buffer[2] ? buffer[3 + slot]
+                                                      : static_cast<std::uint64_t>(static_cast<double>(buffer[3 + slot])*scale);
+    }
+#endif
+    return counts;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+enum class HardwareEvent
+{
+    cycles,
+    instructions,
+    // last level cache
+    cacheMisses,
+    branchMisses
+};
+
+constexpr std::size_t hardwareEventCount{4};
+
+using EventCounts = std::array<std::uint64_t, hardwareEventCount>;
+
+// Hardware counters of the calling thread, user space only, read through
+// Linux perf_event_open as one group. Opening never throws: events the
+// kernel refuses stay unavailable and read as 0, which is all of them on
+// other systems, in most containers and VMs without a virtual PMU, and
+// with kernel.perf_event_paranoid above 2. Counts are scaled up when the
+// kernel multiplexes the group with other users of the PMU.
+class PerfEventGroup
+{
+    public:
+        PerfEventGroup() noexcept;
+        ~PerfEventGroup();
+
+        PerfEventGroup(const PerfEventGroup&) = delete;
+        auto operator=(const PerfEventGroup&) -> PerfEventGroup& = delete;
+
+        auto available() const noexcept -> bool;
+        auto available(HardwareEvent event) const noexcept -> bool;
+        // errno of the first event that could not be opened, 0 if none
+        auto error() const noexcept -> int;
+        // totals since opening; take differences to measure a stretch
+        auto read() const noexcept -> EventCounts;
+
+    private:
+        std::array<int, hardwareEventCount> _fds;
+        // position of each open event in the group read, in opening order
+        std::array<std::size_t, hardwareEventCount> _slots{};
+        std::size_t _opened{0};
+        int _error{0};
+};
@@ -0,0 +1,117 @@
+#include "PixelFormat.hpp"
+#include "Color.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+auto bitsOf(float value) noexcept -> std::uint32_t
+{
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+auto floatOf(std::uint32_t bits) noexcept -> float
+{
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// drops the low `shift` bits, rounding half to even
+auto roundShift(std::uint32_t value, std::uint32_t shift) noexcept -> std::uint32_t
+{
+    const auto kept = value >> shift;
+    const auto remainder = value & ((1u << shift) - 1u);
+    const auto half = 1u << (shift - 1u);
+    return kept + ((remainder > half || (remainder == half && (kept & 1u))) ? 1u : 0u);
+}
+
+auto srgbCurve(float linear) noexcept -> float
+{
+    return linear <= 0.0031308f ? 12.92f*linear : 1.055f*std::pow(linear, 1.f/2.4f) - 0.055f;
+}
+
+auto linearCurve(float encoded) noexcept -> float
+{
+    return encoded <= 0.04045f ? encoded/12.92f : std::pow((encoded + 0.055f)/1.055f, 2.4f);
+}
+}
+
+auto bytesPerPixel(PixelFormat format) noexcept -> std::size_t
+{
+    switch (format) {
+    case PixelFormat::planarFloat:
+        return 3*sizeof(float);
+    case PixelFormat::rgbHalf:
+        return 3*sizeof(std::uint16_t);
+    case PixelFormat::srgb8:
+        return 3;
+    default:
+        return sizeof(Color);
+    }
+}
+
+auto toHalf(float value) noexcept -> std::uint16_t
+{
+    const auto bits = bitsOf(value);
+    const auto sign = static_cast<std::uint16_t>((bits >> 16) & 0x8000u);
+    const auto exponent = static_cast<std::int32_t>((bits >> 23) & 0xffu);
+    const auto mantissa = bits & 0x7fffffu;
+    if (exponent == 0xff) {
+        const auto nan = mantissa != 0 ? 0x200u | (mantissa >> 13) : 0u;
+        return static_cast<std::uint16_t>(sign | 0x7c00u | nan);
+    }
+    const auto halfExponent = exponent - 127 + 15;
+    if (halfExponent >= 31) {
+        return static_cast<std::uint16_t>(sign | 0x7c00u);
+    }
+    if (halfExponent <= 0) {
+        // subnormal, rounding may carry into the smallest normal
+        if (halfExponent < -10) {
+            return sign;
+        }
+        const auto shift = static_cast<std::uint32_t>(14 - halfExponent);
+        return static_cast<std::uint16_t>(sign | roundShift(mantissa | 0x800000u, shift));
+    }
+    // a carry out of the mantissa bumps the exponent, up to infinity
+    const auto rounded = roundShift(static_cast<std::uint32_t>(halfExponent) << 23 | mantissa, 13);
+    return static_cast<std::uint16_t>(sign | rounded);
+}
+
+auto fromHalf(std::uint16_t half) noexcept -> float
+{
+    const auto sign = (half & 0x8000u) << 16;
+    const auto exponent = (half >> 10) & 0x1fu;
+    const auto mantissa = half & 0x3ffu;
+    if (exponent == 0) {
+        const auto magnitude = static_cast<float>(mantissa)*5.9604645e-8f;
+        return sign ? -magnitude : magnitude;
+    }
+    if (exponent == 0x1f) {
+        return floatOf(sign | 0x7f800000u | mantissa << 13);
+    }
+    return floatOf(sign | (exponent + 112u) << 23 | mantissa << 13);
+}
+
+auto encodeSrgb8(float linear) noexcept -> std::uint8_t
+{
+    const auto clamped = std::min(std::max(0.f, linear), 1.f);
+    return static_cast<std::uint8_t>(srgbCurve(clamped)*255.f + 0.5f);
+}
+
+auto decodeSrgb8(std::uint8_t encoded) noexcept -> float
+{
+    static const auto table = []() {
+        std::array<float, 256> values{};
+        for (std::size_t code{0}; code < values.size(); ++code) {
+            values[code] = linearCurve(static_cast<float>(code)/255.f);
+        }
+        return values;
+    }();
+    return table[encoded];
+}
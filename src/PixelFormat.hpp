@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// How a Canvas stores the channels of its pixels: a float Color each,
+// separate float planes for red, green and blue, three IEEE half floats,
+// or three bytes encoded with the sRGB transfer curve. All but rgbFloat
+// are converted from and to Color on every pixel access.
+enum class PixelFormat
+{
+    rgbFloat,
+    planarFloat,
+    rgbHalf,
+    srgb8
+};
+
+auto bytesPerPixel(PixelFormat format) noexcept -> std::size_t;
+
+// binary16 rounded to nearest even; too large values become infinity
+auto toHalf(float value) noexcept -> std::uint16_t;
+auto fromHalf(std::uint16_t half) noexcept -> float;
+
+// Linear intensity to the nearest 8 bit sRGB code, clamped to [0, 1] with
+// NaN giving 0, and back.
+auto encodeSrgb8(float linear) noexcept -> std::uint8_t;
+auto decodeSrgb8(std::uint8_t encoded) noexcept -> float;
@@ -0,0 +1,92 @@
+#include "PlaneFile.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+
+namespace planefile
+{
+namespace
+{
+struct Header
+{
+    char magic[8];
+    std::uint64_t width;
+    std::uint64_t height;
+};
+
+// bytes of the planes, or nothing when they would not fit next to the
+// header in a size_t
+auto planeBytes(std::uint64_t width, std::uint64_t height, std::size_t pixelBytes) noexcept -> std::optional<std::size_t>
+{
+    constexpr auto limit = std::numeric_limits<std::size_t>::max() - sizeof(Header);
+    if (width != 0 && height > limit/width) {
+        return std::nullopt;
+    }
+    const auto pixels = width*height;
+    if (pixelBytes != 0 && pixels > limit/pixelBytes) {
+        return std::nullopt;
+    }
+    return pixels*pixelBytes;
+}
+}
+
+Reader::Reader(const std::filesystem::path& filePath,
+               const Magic& magic,
+               std::size_t pixelBytes,
+               const std::string& kind)
+{
+    std::ifstream file{filePath, std::ios::binary | std::ios::ate};
+    if (!file) {
+        throw std::runtime_error("Cannot open " + kind + " " + filePath.string());
+    }
+    _content.resize(static_cast<std::size_t>(file.tellg()));
+    file.seekg(0);
+    if (!file.read(_content.data(), static_cast<std::streamsize>(_content.size()))) {
+        throw std::runtime_error("Cannot read " + kind + " " + filePath.string());
+    }
+    Header header{};
+    if (_content.size() >= sizeof(header)) {
+        std::memcpy(&header, _content.data(), sizeof(header));
+    }
+    const auto bytes = planeBytes(header.width, header.height, pixelBytes);
+    if (std::memcmp(header.magic, magic.data(), magic.size()) != 0 ||
+        !bytes || _content.size() != sizeof(header) + *bytes) {
+        throw std::runtime_error("Not a " + kind + ": " + filePath.string());
+    }
+    _width = header.width;
+    _height = header.height;
+    _next = _content.data() + sizeof(header);
+}
+
+auto Reader::width() const noexcept -> std::size_t
+{
+    return _width;
+}
+
+auto Reader::height() const noexcept -> std::size_t
+{
+    return _height;
+}
+
+Writer::Writer(const Magic& magic, std::size_t width, std::size_t height, std::size_t pixelBytes):
+    _content(sizeof(Header) + width*height*pixelBytes)
+{
+    Header header{};
+    std::memcpy(header.magic, magic.data(), magic.size());
+    header.width = width;
+    header.height = height;
+    std::memcpy(_content.data(), &header, sizeof(header));
+    _next = _content.data() + sizeof(header);
+}
+
+auto Writer::save(const std::filesystem::path& filePath, const std::string& kind) const -> void
+{
+    std::ofstream file{filePath, std::ios::binary | std::ios::trunc};
+    if (!file.write(_content.data(), static_cast<std::streamsize>(_content.size())) || !file.flush()) {
+        throw std::runtime_error("Cannot write " + kind + " " + filePath.string());
+    }
+}
+}
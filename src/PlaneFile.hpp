@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// Files of per-pixel data: an 8 byte magic, width and height as 64 bit
+// integers, then one plane after the other, each holding one fixed size
+// value for every pixel in row order, all in native byte order. Sample
+// checkpoints and cost maps are stored this way.
+namespace planefile
+{
+using Magic = std::array<char, 8>;
+
+// A whole file read into memory, its planes handed out in order.
+class Reader
+{
+    public:
+        // Throws std::runtime_error when the file cannot be opened, or when
+        // it does not start with `magic` or is not exactly the header and
+        // `pixelBytes` for every pixel long. A width and height whose
+        // planes would not fit in memory are rejected, not wrapped around.
+        Reader(const std::filesystem::path& filePath,
+               const Magic& magic,
+               std::size_t pixelBytes,
+               const std::string& kind);
+
+        auto width() const noexcept -> std::size_t;
+        auto height() const noexcept -> std::size_t;
+
+        // Reads the next plane into one Value per element of pixels,
+        // handing each to store(pixel, value).
+        template<typename Value, typename Pixels, typename Store>
+        auto plane(Pixels& pixels, const Store& store) -> void
+        {
+            for (auto& pixel: pixels) {
+                Value value;
+                std::memcpy(&value, _next, sizeof(value));
+                store(pixel, value);
+                _next += sizeof(value);
+            }
+        }
+
+    private:
+        std::vector<char> _content;
+        std::size_t _width{0};
+        std::size_t _height{0};
+        const char* _next{nullptr};
+};
+
+// Assembles a file in memory and writes it at once.
+class Writer
+{
+    public:
+        Writer(const Magic& magic, std::size_t width, std::size_t height, std::size_t pixelBytes);
+
+        // Appends one Value per element of pixels, taken from load(pixel).
+        template<typename Value, typename Pixels, typename Load>
+        auto plane(const Pixels& pixels, const Load& load) -> void
+        {
+            for (const auto& pixel: pixels) {
+                const Value value = load(pixel);
+                std::memcpy(_next, &value, sizeof(value));
+                _next += sizeof(value);
+            }
+        }
+
+        // Throws std::runtime_error("Cannot write <kind> <path>") on failure.
+        auto save(const std::filesystem::path& filePath, const std::string& kind) const -> void;
+
+    private:
+        std::vector<char> _content;
+        char* _next{nullptr};
+};
+}
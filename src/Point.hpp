@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Simd.hpp"
 #include "Utilities.hpp"
 #include "Vector.hpp"
 
@@ -27,13 +28,20 @@ class Point
             if (values.size() > size) {
                 throw std::runtime_error("Too many elements");
             }
-            std::copy(values.begin(), values.end(), _coordinates.begin());
+            std::size_t index{0};
+            for (const auto value: values) {
+                _coordinates[index++] = value;
+            }
         }
 
         auto& operator-=(const Vector<size>& rhs)
         {
-            for (std::size_t i{0}; i < size; ++i) {
-                _coordinates[i] -= rhs.at(i);
+            if constexpr (size == 4) {
+                simd::store(data(), simd::sub(simd::load(data()), simd::load(rhs.data())));
+            } else {
+                for (std::size_t i{0}; i < size; ++i) {
+                    _coordinates[i] -= rhs[i];
+                }
             }
             return *this;
         }
@@ -54,8 +62,45 @@ class Point
             return _coordinates[position];
         }
 
+        constexpr auto& operator[](std::size_t position) const noexcept
+        {
+            RAY_TRACER_ASSERT_INDEX(position < size);
+            return _coordinates[position];
+        }
+
+        constexpr auto& operator[](std::size_t position) noexcept
+        {
+            RAY_TRACER_ASSERT_INDEX(position < size);
+            return _coordinates[position];
+        }
+
+        template<std::size_t position>
+        constexpr auto& get() const noexcept
+        {
+            static_assert(position < size, "Index out of bounds");
+            return std::get<position>(_coordinates);
+        }
+
+        template<std::size_t position>
+        constexpr auto& get() noexcept
+        {
+            static_assert(position < size, "Index out of bounds");
+            return std::get<position>(_coordinates);
+        }
+
+        auto data() const noexcept -> const float*
+        {
+            return _coordinates.data();
+        }
+
+        auto data() noexcept -> float*
+        {
+            return _coordinates.data();
+        }
+
     private:
-        std::array<float, size> _coordinates{};
+        // 4-component points are kept 16-byte aligned for the simd kernels
+        alignas(size == 4 ? 16 : alignof(float)) std::array<float, size> _coordinates{};
 };
 
 using Point2 = Point<2>;
@@ -67,7 +112,7 @@ inline auto operator==(const Point<size>& lhs, const Point<size>& rhs)
 {
     auto result = true;
     for (std::size_t i{0}; i < size; ++i) {
-        result &= relativelyEqual(lhs.at(i), rhs.at(i));
+        result &= relativelyEqual(lhs[i], rhs[i]);
     }
     return result;
 }
@@ -76,8 +121,12 @@ template<std::size_t size>
 inline auto operator+(const Point<size>& lhs, const Vector<size>& rhs)
 {
     Vector<size> tmp;
-    for (std::size_t i{0}; i < size; ++i) {
-        tmp.at(i) = rhs.at(i) + lhs.at(i);
+    if constexpr (size == 4) {
+        simd::store(tmp.data(), simd::add(simd::load(rhs.data()), simd::load(lhs.data())));
+    } else {
+        for (std::size_t i{0}; i < size; ++i) {
+            tmp[i] = rhs[i] + lhs[i];
+        }
     }
     return tmp;
 }
@@ -86,8 +135,12 @@ template<std::size_t size>
 inline auto operator-(const Point<size>& lhs, const Point<size>& rhs)
 {
     Vector<size> tmp;
-    for (std::size_t i{0}; i < size; ++i) {
-        tmp.at(i) = lhs.at(i) - rhs.at(i);
+    if constexpr (size == 4) {
+        simd::store(tmp.data(), simd::sub(simd::load(lhs.data()), simd::load(rhs.data())));
+    } else {
+        for (std::size_t i{0}; i < size; ++i) {
+            tmp[i] = lhs[i] - rhs[i];
+        }
     }
     return tmp;
 }
@@ -103,8 +156,8 @@ inline auto operator<<(std::ostream& ost, const Point<size>& p) -> std::ostream&
 {
     ost << "(";
     for (std::size_t i{0}; i < size-1; ++i) {
-        ost << p.at(i) << ",";
+        ost << p[i] << ",";
     }
-    ost << p.at(size-1) << ")";
+    ost << p[size-1] << ")";
     return ost;
 }
@@ -0,0 +1,65 @@
+#include "ProgressiveRenderer.hpp"
+#include "Canvas.hpp"
+#include "Renderer.hpp"
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+ProgressiveRenderer::ProgressiveRenderer(const Renderer& renderer, const ProgressiveSettings& settings):
+    _renderer{renderer},
+    _settings{settings}
+{
+    if (_settings.maxPassSamples == 0) {
+        throw std::runtime_error("Passes must take at least one sample");
+    }
+}
+
+auto ProgressiveRenderer::render(Canvas& canvas, ThreadPool& pool, const PassCallback& onPass) const -> bool
+{
+    auto buffer = start(canvas);
+    const auto checkpointing = !_settings.checkpoint.empty();
+    auto lastCheckpoint = std::chrono::steady_clock::now();
+    auto samples = buffer.minSamples();
+    while (samples < _settings.samplesPerPixel) {
+        samples = nextPass(samples);
+        const trace::Span span{"pass", samples};
+        _renderer.accumulate(buffer, samples, pool);
+        const auto finished = samples >= _settings.samplesPerPixel;
+        const auto proceed = !onPass || onPass(buffer);
+        const auto stop = !finished && !proceed;
+        const auto now = std::chrono::steady_clock::now();
+        if (checkpointing && !finished && (stop || now - lastCheckpoint >= _settings.checkpointInterval)) {
+            buffer.save(_settings.checkpoint);
+            lastCheckpoint = now;
+        }
+        if (stop) {
+            buffer.resolve(canvas);
+            return false;
+        }
+    }
+    buffer.resolve(canvas);
+    if (checkpointing) {
+        std::filesystem::remove(_settings.checkpoint);
+    }
+    return true;
+}
+
+auto ProgressiveRenderer::nextPass(std::uint32_t samples) const noexcept -> std::uint32_t
+{
+    const auto pass = std::clamp(samples, std::uint32_t{1}, _settings.maxPassSamples);
+    return std::min(samples + pass, _settings.samplesPerPixel);
+}
+
+auto ProgressiveRenderer::start(const Canvas& canvas) const -> SampleBuffer
+{
+    if (_settings.checkpoint.empty() || !std::filesystem::exists(_settings.checkpoint)) {
+        return SampleBuffer{canvas.width(), canvas.height()};
+    }
+    auto buffer = SampleBuffer::load(_settings.checkpoint);
+    if (buffer.width() != canvas.width() || buffer.height() != canvas.height()) {
+        throw std::runtime_error("Checkpoint size does not match canvas: " + _settings.checkpoint.string());
+    }
+    return buffer;
+}
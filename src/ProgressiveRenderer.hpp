@@ -0,0 +1,54 @@
+#pragma once
+
+#include "SampleBuffer.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+
+class Canvas;
+class Renderer;
+class ThreadPool;
+
+struct ProgressiveSettings
+{
+    std::uint32_t samplesPerPixel{16};
+    // the first pass takes one sample per pixel, every further pass as
+    // many as all before it, up to this many
+    std::uint32_t maxPassSamples{8};
+    // where the samples are checkpointed; empty for no checkpoints
+    std::filesystem::path checkpoint;
+    // least time between two checkpoints, zero for one after every pass
+    std::chrono::milliseconds checkpointInterval{0};
+};
+
+// Renders in passes of more samples per pixel, coarse to fine, so a
+// usable image exists early and a preempted render loses at most the
+// passes since the last checkpoint. A render that finds a checkpoint
+// continues from it and ends with the same image, bit for bit, as one
+// that was never interrupted. The checkpoint does not record the scene:
+// resuming with another scene or camera mixes the two.
+class ProgressiveRenderer
+{
+    public:
+        // Called after every pass with the samples so far; returning false
+        // stops the render after a checkpoint of them.
+        using PassCallback = std::function<bool(const SampleBuffer& samples)>;
+
+        explicit ProgressiveRenderer(const Renderer& renderer, const ProgressiveSettings& settings = {});
+
+        // Writes the mean of the samples taken so far into the canvas and
+        // returns whether all of them are taken, in which case the
+        // checkpoint is removed.
+        auto render(Canvas& canvas, ThreadPool& pool, const PassCallback& onPass = {}) const -> bool;
+
+        // samples per pixel after the pass that follows `samples`
+        auto nextPass(std::uint32_t samples) const noexcept -> std::uint32_t;
+
+    private:
+        auto start(const Canvas& canvas) const -> SampleBuffer;
+
+        const Renderer& _renderer;
+        ProgressiveSettings _settings;
+};
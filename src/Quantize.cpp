@@ -0,0 +1,148 @@
+#include "Quantize.hpp"
+#include "Color.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+// Pixels are processed in blocks: a contiguous pass over the four floats
+// of every Color (padding lane included) that the compiler vectorizes,
+// into a small buffer of codes, then a pass dropping the padding lane.
+namespace
+{
+constexpr std::size_t blockPixels{64};
+constexpr std::size_t lanes{4};
+
+// intervals of the sRGB table; linear interpolation between its entries
+// stays within a fraction of a 16 bit code of the exact curve
+constexpr std::size_t srgbIntervals{8192};
+using SrgbTable = std::array<float, srgbIntervals + 2>;
+
+auto srgbTable() -> const SrgbTable&
+{
+    static const auto table = []() {
+        SrgbTable values{};
+        for (std::size_t i{0}; i <= srgbIntervals; ++i) {
+            const auto linear = static_cast<double>(i)/srgbIntervals;
+            values[i] = static_cast<float>(linear <= 0.0031308 ? 12.92*linear
+                                                               : 1.055*std::pow(linear, 1.0/2.4) - 0.055);
+        }
+        // lets an input of exactly 1 interpolate without a bounds check
+        values[srgbIntervals + 1] = values[srgbIntervals];
+        return values;
+    }();
+    return table;
+}
+
+constexpr float bayer[4][4]{{0.f, 8.f, 2.f, 10.f},
+                            {12.f, 4.f, 14.f, 6.f},
+                            {3.f, 11.f, 1.f, 9.f},
+                            {15.f, 7.f, 13.f, 5.f}};
+
+// Rounding offset of every lane of four consecutive pixels: one half, or
+// with dither a threshold between 1/32 and 31/32 of a code. The result
+// stays within [0, maxValue] either way.
+auto roundingOffsets(std::size_t y, bool dither) noexcept -> std::array<float, 4*lanes>
+{
+    std::array<float, 4*lanes> offsets{};
+    for (std::size_t lane{0}; lane < offsets.size(); ++lane) {
+        offsets[lane] = dither ? (bayer[y % 4][lane/lanes] + 0.5f)/16.f : 0.5f;
+    }
+    return offsets;
+}
+
+template<bool srgb>
+auto code(float value, float maxValue, float offset, const SrgbTable& table) noexcept -> std::int32_t
+{
+    // written so NaN becomes 0
+    auto clamped = std::min(value > 0.f ? value : 0.f, 1.f);
+    if constexpr (srgb) {
+        const auto position = clamped*static_cast<float>(srgbIntervals);
+        const auto index = static_cast<std::size_t>(position);
+        const auto fraction = position - static_cast<float>(index);
+        clamped = table[index] + fraction*(table[index + 1] - table[index]);
+    }
+    return static_cast<std::int32_t>(clamped*maxValue + offset);
+}
+
+// Codes of `count` pixels into `bytes` per lane, most significant byte
+// first; x of the first pixel is a multiple of four.
+template<bool srgb, std::size_t bytes>
+auto quantizeBlock(const float* channels,
+                   std::size_t count,
+                   float maxValue,
+                   const std::array<float, 4*lanes>& offsets,
+                   std::uint8_t* out) noexcept -> void
+{
+    const auto& table = srgbTable();
+    const auto put = [out](std::size_t lane, std::int32_t value) {
+        if constexpr (bytes == 2) {
+            out[2*lane] = static_cast<std::uint8_t>(value >> 8);
+            out[2*lane + 1] = static_cast<std::uint8_t>(value);
+        } else {
+            out[lane] = static_cast<std::uint8_t>(value);
+        }
+    };
+    const auto whole = count - count % 4;
+    for (std::size_t group{0}; group < whole; group += 4) {
+        for (std::size_t lane{0}; lane < 4*lanes; ++lane) {
+            put(group*lanes + lane, code<srgb>(channels[group*lanes + lane], maxValue, offsets[lane], table));
+        }
+    }
+    for (auto lane = whole*lanes; lane < count*lanes; ++lane) {
+        put(lane, code<srgb>(channels[lane], maxValue, offsets[lane % (4*lanes)], table));
+    }
+}
+
+// Every pixel is copied with its padding lane, which the next pixel then
+// overwrites; only the last pixel of the row is copied without it.
+template<std::size_t bytes>
+auto quantizeRow(const Color* pixels,
+                 std::size_t count,
+                 std::size_t y,
+                 const Quantization& quantization,
+                 std::uint8_t* out) noexcept -> void
+{
+    constexpr auto maxValue = bytes == 2 ? 65535.f : 255.f;
+    constexpr auto paddedBytes = lanes*bytes;
+    constexpr auto pixelBytes = 3*bytes;
+    const auto offsets = roundingOffsets(y, quantization.dither);
+    alignas(64) std::uint8_t codes[blockPixels*paddedBytes];
+    const auto* const channels = &pixels->r();
+    for (std::size_t begin{0}; begin < count; begin += blockPixels) {
+        const auto size = std::min(blockPixels, count - begin);
+        if (quantization.srgb) {
+            quantizeBlock<true, bytes>(channels + begin*lanes, size, maxValue, offsets, codes);
+        } else {
+            quantizeBlock<false, bytes>(channels + begin*lanes, size, maxValue, offsets, codes);
+        }
+        const auto padded = begin + size < count ? size : size - 1;
+        auto* const target = out + begin*pixelBytes;
+        for (std::size_t pixel{0}; pixel < padded; ++pixel) {
+            std::memcpy(target + pixel*pixelBytes, codes + pixel*paddedBytes, paddedBytes);
+        }
+        if (padded < size) {
+            std::memcpy(target + padded*pixelBytes, codes + padded*paddedBytes, pixelBytes);
+        }
+    }
+}
+}
+
+auto quantizeRow8(const Color* pixels,
+                  std::size_t count,
+                  std::size_t y,
+                  const Quantization& quantization,
+                  std::uint8_t* out) noexcept -> void
+{
+    quantizeRow<1>(pixels, count, y, quantization, out);
+}
+
+auto quantizeRow16(const Color* pixels,
+                   std::size_t count,
+                   std::size_t y,
+                   const Quantization& quantization,
+                   std::uint8_t* out) noexcept -> void
+{
+    quantizeRow<2>(pixels, count, y, quantization, out);
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+class Color;
+
+// How image writers turn float channels into integers. Channels are
+// clamped to [0, 1] (NaN gives 0), optionally mapped through the sRGB
+// transfer curve, and rounded to the nearest code; with dither the
+// rounding threshold follows a 4x4 ordered (Bayer) pattern instead, which
+// trades banding in smooth gradients for fine noise.
+struct Quantization
+{
+    bool srgb{false};
+    bool dither{false};
+};
+
+// Quantizes `count` pixels of image row `y` to three bytes per pixel.
+auto quantizeRow8(const Color* pixels,
+                  std::size_t count,
+                  std::size_t y,
+                  const Quantization& quantization,
+                  std::uint8_t* out) noexcept -> void;
+
+// Same with 16 bit channels, each stored most significant byte first.
+auto quantizeRow16(const Color* pixels,
+                   std::size_t count,
+                   std::size_t y,
+                   const Quantization& quantization,
+                   std::uint8_t* out) noexcept -> void;
@@ -21,3 +21,12 @@ auto Ray::origin() const -> const Point4&
     return _origin;
 }
 
+auto Ray::transform(const Mat4& matrix) const -> Ray
+{
+    return Ray{matrix*_origin, matrix*_direction};
+}
+
+auto Ray::transform(const Affine3& matrix) const -> Ray
+{
+    return Ray{matrix*_origin, matrix*_direction};
+}
@@ -1,18 +1,23 @@
 #pragma once
 
+#include "Affine.hpp"
+#include "Matrix.hpp"
 #include "Point.hpp"
 #include "Vector.hpp"
 
 class Ray
 {
     public:
+        Ray() = default;
         Ray(const Point4& origin, const Vec4& direction);
 
         auto position(float time) const -> Point4;
         auto direction() const -> const Vec4&;
         auto origin() const -> const Point4&;
+        auto transform(const Mat4& matrix) const -> Ray;
+        auto transform(const Affine3& matrix) const -> Ray;
 
     private:
-        Vec4 _direction;
         Point4 _origin;
+        Vec4 _direction;
 };
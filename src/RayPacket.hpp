@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Ray.hpp"
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+// Structure-of-arrays bundle of rays, one lane per ray. Kernels working on
+// it loop over lanes without branches so the compiler maps them onto the
+// widest vector unit available (SSE for 4, AVX for 8, AVX-512 for 16).
+template<std::size_t lanes>
+struct RayPacket
+{
+    static_assert(lanes == 4 || lanes == 8 || lanes == 16,
+                  "RayPacket supports 4, 8 or 16 lanes");
+
+    auto setRay(std::size_t lane, const Ray& ray) noexcept -> void
+    {
+        originX[lane] = ray.origin()[0];
+        originY[lane] = ray.origin()[1];
+        originZ[lane] = ray.origin()[2];
+        directionX[lane] = ray.direction()[0];
+        directionY[lane] = ray.direction()[1];
+        directionZ[lane] = ray.direction()[2];
+        active[lane] = 1;
+    }
+
+    alignas(64) std::array<float, lanes> originX{};
+    alignas(64) std::array<float, lanes> originY{};
+    alignas(64) std::array<float, lanes> originZ{};
+    alignas(64) std::array<float, lanes> directionX{};
+    alignas(64) std::array<float, lanes> directionY{};
+    alignas(64) std::array<float, lanes> directionZ{};
+    alignas(64) std::array<std::uint32_t, lanes> active{};
+};
+
+// Nearest hit per lane of a RayPacket.
+template<std::size_t lanes>
+struct PacketHits
+{
+    static constexpr auto miss = std::numeric_limits<std::size_t>::max();
+
+    PacketHits() noexcept
+    {
+        t.fill(std::numeric_limits<float>::infinity());
+        object.fill(miss);
+    }
+
+    auto hit(std::size_t lane) const noexcept -> bool
+    {
+        return object[lane] != miss;
+    }
+
+    alignas(64) std::array<float, lanes> t;
+    alignas(64) std::array<std::size_t, lanes> object;
+};
@@ -0,0 +1,222 @@
+#include "Renderer.hpp"
+#include "Trace.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <utility>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace
+{
+// Point of sample i within its pixel: the additive recurrence of the
+// plastic constant (R2 sequence), which spreads any run of consecutive
+// samples evenly over the pixel and starts at its centre.
+auto samplePosition(std::uint32_t sample) noexcept -> std::pair<float, float>
+{
+    constexpr auto a1 = 0.7548776662466927;
+    constexpr auto a2 = 0.5698402909980532;
+    double whole;
+    return {static_cast<float>(std::modf(0.5 + a1*sample, &whole)),
+            static_cast<float>(std::modf(0.5 + a2*sample, &whole))};
+}
+
+// time stamp counter, or nanoseconds where there is none
+auto cycles() noexcept -> std::uint64_t
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+}
+
+Renderer::Renderer(const Scene& scene, const Camera& camera, const RenderSettings& settings):
+    _scene{scene},
+    _camera{camera},
+    _settings{settings}
+{
+    if (_settings.tileSize == 0) {
+        throw std::runtime_error("Tile size must not be zero");
+    }
+}
+
+auto Renderer::render(Canvas& canvas) const -> void
+{
+    checkCanvas(canvas);
+    const instrument::ScopedPhase phase{instrument::Phase::render};
+    const trace::Span span{"render"};
+    renderTile(canvas, Tile{0, 0, canvas.width(), canvas.height()});
+}
+
+auto Renderer::render(Canvas& canvas, ThreadPool& pool) const -> void
+{
+    checkCanvas(canvas);
+    const instrument::ScopedPhase phase{instrument::Phase::render};
+    const trace::Span span{"render"};
+    pool.run(tileCount(canvas), [&](std::size_t index) {
+        const trace::Span tileSpan{"tile", static_cast<std::int64_t>(index)};
+        renderTile(canvas, tile(canvas, index));
+    });
+}
+
+auto Renderer::accumulate(SampleBuffer& buffer, std::uint32_t samples) const -> void
+{
+    checkSize(buffer.width(), buffer.height());
+    const instrument::ScopedPhase phase{instrument::Phase::render};
+    const trace::Span span{"accumulate"};
+    accumulateTile(buffer, samples, Tile{0, 0, buffer.width(), buffer.height()});
+}
+
+auto Renderer::accumulate(SampleBuffer& buffer, std::uint32_t samples, ThreadPool& pool) const -> void
+{
+    checkSize(buffer.width(), buffer.height());
+    const instrument::ScopedPhase phase{instrument::Phase::render};
+    const trace::Span span{"accumulate"};
+    pool.run(tileCount(buffer.width(), buffer.height()), [&](std::size_t index) {
+        const trace::Span tileSpan{"tile", static_cast<std::int64_t>(index)};
+        accumulateTile(buffer, samples, tile(buffer.width(), buffer.height(), index));
+    });
+}
+
+auto Renderer::renderCosts(Canvas& canvas, CostMap& costs) const -> void
+{
+    checkCosts(canvas, costs);
+    const instrument::ScopedPhase phase{instrument::Phase::render};
+    const trace::Span span{"render costs"};
+    renderCostTile(canvas, costs, Tile{0, 0, canvas.width(), canvas.height()});
+}
+
+auto Renderer::renderCosts(Canvas& canvas, CostMap& costs, ThreadPool& pool) const -> void
+{
+    checkCosts(canvas, costs);
+    const instrument::ScopedPhase phase{instrument::Phase::render};
+    const trace::Span span{"render costs"};
+    pool.run(tileCount(canvas), [&](std::size_t index) {
+        const trace::Span tileSpan{"tile", static_cast<std::int64_t>(index)};
+        renderCostTile(canvas, costs, tile(canvas, index));
+    });
+}
+
+auto Renderer::tileCount(const Canvas& canvas) const -> std::size_t
+{
+    return tileCount(canvas.width(), canvas.height());
+}
+
+auto Renderer::tile(const Canvas& canvas, std::size_t index) const -> Tile
+{
+    return tile(canvas.width(), canvas.height(), index);
+}
+
+auto Renderer::tileCount(std::size_t width, std::size_t height) const -> std::size_t
+{
+    const auto size = _settings.tileSize;
+    return ((width + size - 1)/size)*((height + size - 1)/size);
+}
+
+// tiles are numbered row by row, so neighbouring indices share rows
+auto Renderer::tile(std::size_t width, std::size_t height, std::size_t index) const -> Tile
+{
+    const auto size = _settings.tileSize;
+    const auto columns = (width + size - 1)/size;
+    const auto x = (index % columns)*size;
+    const auto y = (index/columns)*size;
+    return Tile{x, y, std::min(size, width - x), std::min(size, height - y)};
+}
+
+// A batch may span several rows of the tile. intersect(ray, x, y) tells
+// whether the ray of pixel (x, y) hits the scene.
+template<typename Intersect>
+auto Renderer::renderTile(Canvas& canvas, const Tile& tile, const Intersect& intersect) const -> void
+{
+    std::array<Ray, batchPixels> rays;
+    std::array<bool, batchPixels> hits;
+    const auto pixels = tile.width*tile.height;
+    for (std::size_t begin{0}; begin < pixels; begin += batchPixels) {
+        const auto size = std::min(batchPixels, pixels - begin);
+        instrument::ScopedPhase phase{instrument::Phase::rayGeneration};
+        for (std::size_t i{0}; i < size; ++i) {
+            rays[i] = _camera.rayForPixel(tile.x + (begin + i) % tile.width, tile.y + (begin + i)/tile.width);
+        }
+        phase.enter(instrument::Phase::intersection);
+        std::size_t hitCount{0};
+        for (std::size_t i{0}; i < size; ++i) {
+            hits[i] = intersect(rays[i], tile.x + (begin + i) % tile.width, tile.y + (begin + i)/tile.width);
+            hitCount += hits[i] ? 1u : 0u;
+        }
+        phase.enter(instrument::Phase::shading);
+        for (std::size_t i{0}; i < size; ++i) {
+            canvas(tile.x + (begin + i) % tile.width, tile.y + (begin + i)/tile.width) =
+                hits[i] ? _settings.hitColor : _settings.background;
+        }
+        instrument::count(instrument::Counter::rays, size);
+        instrument::count(instrument::Counter::hits, hitCount);
+    }
+}
+
+auto Renderer::renderTile(Canvas& canvas, const Tile& tile) const -> void
+{
+    renderTile(canvas, tile, [this](const Ray& ray, std::size_t, std::size_t) {
+        return _scene.hit(ray).has_value();
+    });
+}
+
+auto Renderer::accumulateTile(SampleBuffer& buffer, std::uint32_t samples, const Tile& tile) const -> void
+{
+    std::size_t rays{0};
+    std::size_t hits{0};
+    for (auto y = tile.y; y < tile.y + tile.height; ++y) {
+        for (auto x = tile.x; x < tile.x + tile.width; ++x) {
+            for (auto sample = buffer.samples(x, y); sample < samples; ++sample) {
+                const auto [dx, dy] = samplePosition(sample);
+                const auto hit = _scene.hit(_camera.rayForPixel(x, y, dx, dy));
+                buffer.add(x, y, hit ? _settings.hitColor : _settings.background);
+                ++rays;
+                hits += hit ? 1u : 0u;
+            }
+        }
+    }
+    instrument::count(instrument::Counter::rays, rays);
+    instrument::count(instrument::Counter::hits, hits);
+}
+
+// The clock is read around the intersection of every pixel only: camera
+// ray and shading cost every pixel the same.
+auto Renderer::renderCostTile(Canvas& canvas, CostMap& costs, const Tile& tile) const -> void
+{
+    renderTile(canvas, tile, [this, &costs](const Ray& ray, std::size_t x, std::size_t y) {
+        const auto start = cycles();
+        QueryCost cost;
+        const auto hit = _scene.hit(ray, cost).has_value();
+        const auto ticks = cycles() - start;
+        costs.set(x, y, PixelCost{static_cast<std::uint32_t>(cost.sphereTests),
+                                  static_cast<std::uint32_t>(cost.bvhNodes),
+                                  ticks});
+        return hit;
+    });
+}
+
+auto Renderer::checkCosts(const Canvas& canvas, const CostMap& costs) const -> void
+{
+    checkCanvas(canvas);
+    if (costs.width() != canvas.width() || costs.height() != canvas.height()) {
+        throw std::runtime_error("Cost map size does not match the canvas");
+    }
+}
+
+auto Renderer::checkCanvas(const Canvas& canvas) const -> void
+{
+    checkSize(canvas.width(), canvas.height());
+}
+
+auto Renderer::checkSize(std::size_t width, std::size_t height) const -> void
+{
+    if (width != _camera.hsize() || height != _camera.vsize()) {
+        throw std::runtime_error("Canvas size does not match camera");
+    }
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+#include "Camera.hpp"
+#include "Canvas.hpp"
+#include "Color.hpp"
+#include "CostMap.hpp"
+#include "Instrumentation.hpp"
+#include "Ray.hpp"
+#include "RayPacket.hpp"
+#include "SampleBuffer.hpp"
+#include "Scene.hpp"
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+struct RenderSettings
+{
+    Color hitColor{1.f, 1.f, 1.f};
+    Color background{0.f, 0.f, 0.f};
+    // edge length in pixels of the square tiles handed to a thread pool
+    std::size_t tileSize{32};
+};
+
+// Rectangle [x, x + width) x [y, y + height) of the canvas.
+struct Tile
+{
+    std::size_t x;
+    std::size_t y;
+    std::size_t width;
+    std::size_t height;
+};
+
+// Casts one primary ray per pixel of the camera into the scene. render()
+// traces rays one at a time, renderPackets() traces horizontally coherent
+// runs of `lanes` pixels together. Given a thread pool, both split the
+// canvas into tiles and render them in parallel; every tile is written by
+// one thread straight into the canvas, so no locking is involved. Tiles
+// are rendered in batches of pixels whose rays are generated, intersected
+// and shaded in turn, which lets instrumentation time each phase once per
+// batch rather than per pixel.
+class Renderer
+{
+    public:
+        static constexpr std::size_t batchPixels{256};
+
+        explicit Renderer(const Scene& scene, const Camera& camera, const RenderSettings& settings = {});
+
+        auto render(Canvas& canvas) const -> void;
+        auto render(Canvas& canvas, ThreadPool& pool) const -> void;
+
+        template<std::size_t lanes>
+        auto renderPackets(Canvas& canvas) const -> void
+        {
+            checkCanvas(canvas);
+            const instrument::ScopedPhase phase{instrument::Phase::render};
+            const trace::Span span{"render"};
+            renderPacketTile<lanes>(canvas, Tile{0, 0, canvas.width(), canvas.height()});
+        }
+
+        template<std::size_t lanes>
+        auto renderPackets(Canvas& canvas, ThreadPool& pool) const -> void
+        {
+            checkCanvas(canvas);
+            const instrument::ScopedPhase phase{instrument::Phase::render};
+            const trace::Span span{"render"};
+            pool.run(tileCount(canvas), [&](std::size_t index) {
+                const trace::Span tileSpan{"tile", static_cast<std::int64_t>(index)};
+                renderPacketTile<lanes>(canvas, tile(canvas, index));
+            });
+        }
+
+        // Adds samples to every pixel of the buffer until it has
+        // `samples`. Sample i of a pixel always goes through the same point
+        // of it, the centre for the first, so the sums do not depend on how
+        // the samples are split into calls.
+        auto accumulate(SampleBuffer& buffer, std::uint32_t samples) const -> void;
+        auto accumulate(SampleBuffer& buffer, std::uint32_t samples, ThreadPool& pool) const -> void;
+
+        // Renders like render(), one ray at a time, and records in `costs`
+        // what every pixel took. Slower; meant for finding expensive
+        // regions of a scene.
+        auto renderCosts(Canvas& canvas, CostMap& costs) const -> void;
+        auto renderCosts(Canvas& canvas, CostMap& costs, ThreadPool& pool) const -> void;
+
+        auto tileCount(const Canvas& canvas) const -> std::size_t;
+        auto tile(const Canvas& canvas, std::size_t index) const -> Tile;
+
+    private:
+        auto checkCanvas(const Canvas& canvas) const -> void;
+        auto checkSize(std::size_t width, std::size_t height) const -> void;
+        auto tileCount(std::size_t width, std::size_t height) const -> std::size_t;
+        auto tile(std::size_t width, std::size_t height, std::size_t index) const -> Tile;
+        auto renderTile(Canvas& canvas, const Tile& tile) const -> void;
+        template<typename Intersect>
+        auto renderTile(Canvas& canvas, const Tile& tile, const Intersect& intersect) const -> void;
+        auto accumulateTile(SampleBuffer& buffer, std::uint32_t samples, const Tile& tile) const -> void;
+        auto checkCosts(const Canvas& canvas, const CostMap& costs) const -> void;
+        auto renderCostTile(Canvas& canvas, CostMap& costs, const Tile& tile) const -> void;
+
+        // Packets never span rows; a batch collects the packets of as many
+        // tile rows as fit.
+        template<std::size_t lanes>
+        auto renderPacketTile(Canvas& canvas, const Tile& tile) const -> void
+        {
+            constexpr auto batchPackets = std::max(batchPixels/lanes, std::size_t{1});
+            struct Run
+            {
+                std::size_t x;
+                std::size_t y;
+                std::size_t count;
+            };
+            std::array<Run, batchPackets> runs;
+            std::array<RayPacket<lanes>, batchPackets> packets;
+            std::array<PacketHits<lanes>, batchPackets> hits;
+            auto x = tile.x;
+            auto y = tile.y;
+            while (y < tile.y + tile.height) {
+                instrument::ScopedPhase phase{instrument::Phase::rayGeneration};
+                std::size_t size{0};
+                for (; size < batchPackets && y < tile.y + tile.height; ++size) {
+                    runs[size] = Run{x, y, std::min(lanes, tile.x + tile.width - x)};
+                    packets[size] = RayPacket<lanes>{};
+                    for (std::size_t lane{0}; lane < runs[size].count; ++lane) {
+                        packets[size].setRay(lane, _camera.rayForPixel(x + lane, y));
+                    }
+                    x += lanes;
+                    if (x >= tile.x + tile.width) {
+                        x = tile.x;
+                        ++y;
+                    }
+                }
+                phase.enter(instrument::Phase::intersection);
+                for (std::size_t packet{0}; packet < size; ++packet) {
+                    hits[packet] = PacketHits<lanes>{};
+                    _scene.intersect(packets[packet], hits[packet]);
+                }
+                phase.enter(instrument::Phase::shading);
+                std::size_t rays{0};
+                std::size_t hitCount{0};
+                for (std::size_t packet{0}; packet < size; ++packet) {
+                    const auto& run = runs[packet];
+                    for (std::size_t lane{0}; lane < run.count; ++lane) {
+                        const auto hit = hits[packet].hit(lane);
+                        hitCount += hit ? 1u : 0u;
+                        canvas(run.x + lane, run.y) = hit ? _settings.hitColor : _settings.background;
+                    }
+                    rays += run.count;
+                }
+                instrument::count(instrument::Counter::rays, rays);
+                instrument::count(instrument::Counter::hits, hitCount);
+            }
+        }
+
+        const Scene& _scene;
+        const Camera& _camera;
+        RenderSettings _settings;
+};
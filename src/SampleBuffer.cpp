@@ -0,0 +1,101 @@
+#include "SampleBuffer.hpp"
+#include "Canvas.hpp"
+#include "PlaneFile.hpp"
+#include "Trace.hpp"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <stdexcept>
+
+// A checkpoint is a plane file of the sample count of every pixel followed
+// by the red, green and blue sums of every pixel.
+namespace
+{
+constexpr planefile::Magic checkpointMagic{'R', 'T', 'S', 'A', 'M', 'P', 'L', 'E'};
+
+using Sum = std::array<float, 3>;
+
+constexpr std::size_t checkpointPixelBytes{sizeof(std::uint32_t) + sizeof(Sum)};
+}
+
+SampleBuffer::SampleBuffer(std::size_t width, std::size_t height):
+    _width{width},
+    _height{height},
+    _sums(width*height),
+    _samples(width*height)
+{}
+
+auto SampleBuffer::load(const std::filesystem::path& filePath) -> SampleBuffer
+{
+    planefile::Reader file{filePath, checkpointMagic, checkpointPixelBytes, "sample checkpoint"};
+    SampleBuffer buffer{file.width(), file.height()};
+    file.plane<std::uint32_t>(buffer._samples, [](auto& samples, auto value) { samples = value; });
+    file.plane<Sum>(buffer._sums, [](auto& sum, const auto& channels) {
+        sum = Color{channels[0], channels[1], channels[2]};
+    });
+    return buffer;
+}
+
+auto SampleBuffer::save(const std::filesystem::path& filePath) const -> void
+{
+    const trace::Span span{"checkpoint"};
+    planefile::Writer file{checkpointMagic, _width, _height, checkpointPixelBytes};
+    file.plane<std::uint32_t>(_samples, [](auto samples) { return samples; });
+    file.plane<Sum>(_sums, [](const auto& sum) { return Sum{sum.r(), sum.g(), sum.b()}; });
+
+    auto partial = filePath;
+    partial += ".partial";
+    file.save(partial, "checkpoint");
+    std::filesystem::rename(partial, filePath);
+}
+
+auto SampleBuffer::width() const noexcept -> std::size_t
+{
+    return _width;
+}
+
+auto SampleBuffer::height() const noexcept -> std::size_t
+{
+    return _height;
+}
+
+auto SampleBuffer::samples(std::size_t x, std::size_t y) const noexcept -> std::uint32_t
+{
+    RAY_TRACER_ASSERT_INDEX(x < _width && y < _height);
+    return _samples[y*_width + x];
+}
+
+auto SampleBuffer::minSamples() const noexcept -> std::uint32_t
+{
+    if (_samples.empty()) {
+        return std::numeric_limits<std::uint32_t>::max();
+    }
+    return *std::min_element(_samples.begin(), _samples.end());
+}
+
+auto SampleBuffer::sum(std::size_t x, std::size_t y) const noexcept -> const Color&
+{
+    RAY_TRACER_ASSERT_INDEX(x < _width && y < _height);
+    return _sums[y*_width + x];
+}
+
+auto SampleBuffer::add(std::size_t x, std::size_t y, const Color& sample) noexcept -> void
+{
+    RAY_TRACER_ASSERT_INDEX(x < _width && y < _height);
+    _sums[y*_width + x] += sample;
+    ++_samples[y*_width + x];
+}
+
+auto SampleBuffer::resolve(Canvas& canvas) const -> void
+{
+    if (canvas.width() != _width || canvas.height() != _height) {
+        throw std::runtime_error("Canvas size does not match sample buffer");
+    }
+    for (std::size_t y{0}; y < _height; ++y) {
+        for (std::size_t x{0}; x < _width; ++x) {
+            const auto count = _samples[y*_width + x];
+            canvas(x, y) = count == 0 ? Color{} : _sums[y*_width + x]*(1.f/static_cast<float>(count));
+        }
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Color.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+class Canvas;
+
+// Running sum and number of samples of every pixel of a progressive
+// render, row by row. Checkpoints keep the sums bit for bit, so rendering
+// further samples after load() ends exactly where an uninterrupted render
+// would.
+class SampleBuffer
+{
+    public:
+        explicit SampleBuffer(std::size_t width, std::size_t height);
+
+        // throws unless the file is a complete checkpoint
+        static auto load(const std::filesystem::path& filePath) -> SampleBuffer;
+        // written next to filePath and renamed over it, so an interrupted
+        // save leaves the previous checkpoint intact
+        auto save(const std::filesystem::path& filePath) const -> void;
+
+        auto width() const noexcept -> std::size_t;
+        auto height() const noexcept -> std::size_t;
+        auto samples(std::size_t x, std::size_t y) const noexcept -> std::uint32_t;
+        // fewest samples of any pixel
+        auto minSamples() const noexcept -> std::uint32_t;
+        auto sum(std::size_t x, std::size_t y) const noexcept -> const Color&;
+        auto add(std::size_t x, std::size_t y, const Color& sample) noexcept -> void;
+        // mean of the samples of every pixel, black where there are none
+        auto resolve(Canvas& canvas) const -> void;
+
+    private:
+        std::size_t _width;
+        std::size_t _height;
+        std::vector<Color> _sums;
+        std::vector<std::uint32_t> _samples;
+};
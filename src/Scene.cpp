@@ -0,0 +1,80 @@
+#include "Scene.hpp"
+#include "Instrumentation.hpp"
+#include "Ray.hpp"
+#include "Trace.hpp"
+
+auto Scene::add(const Sphere& sphere) -> std::size_t
+{
+    _bvhCurrent = false;
+    _bvh = Bvh{};
+    return _spheres.add(sphere);
+}
+
+auto Scene::setTransform(std::size_t id, const Transform& transform) -> void
+{
+    _spheres.setTransform(id, transform);
+    _bvhCurrent = false;
+}
+
+auto Scene::build() -> void
+{
+    const instrument::ScopedPhase phase{instrument::Phase::bvhBuild};
+    const trace::Span span{"bvh build"};
+    _bvh = Bvh{_spheres.bounds()};
+    _bvhCurrent = true;
+}
+
+auto Scene::refit() -> void
+{
+    if (_bvh.empty()) {
+        build();
+        return;
+    }
+    const instrument::ScopedPhase phase{instrument::Phase::bvhBuild};
+    const trace::Span span{"bvh refit"};
+    _bvh.refit(_spheres.bounds());
+    _bvhCurrent = true;
+}
+
+auto Scene::accelerated() const noexcept -> bool
+{
+    return _bvhCurrent && !_bvh.empty();
+}
+
+auto Scene::spheres() const noexcept -> const SphereSet&
+{
+    return _spheres;
+}
+
+auto Scene::bvh() const noexcept -> const Bvh&
+{
+    return _bvh;
+}
+
+auto Scene::intersect(const Ray& ray, Intersections& intersections) const -> void
+{
+    _spheres.intersect(ray, intersections);
+}
+
+auto Scene::hit(const Ray& ray) const -> std::optional<Intersection>
+{
+    QueryCost cost;
+    return hit(ray, cost);
+}
+
+auto Scene::hit(const Ray& ray, QueryCost& cost) const -> std::optional<Intersection>
+{
+    if (!accelerated()) {
+        instrument::count(instrument::Counter::sphereTests, _spheres.size());
+        cost.sphereTests += _spheres.size();
+        return _spheres.nearest(ray);
+    }
+    std::size_t tests{0};
+    const auto hit = _bvh.nearest(ray, [&](std::size_t id) {
+        ++tests;
+        return _spheres.nearest(ray, id);
+    }, cost.bvhNodes);
+    instrument::count(instrument::Counter::sphereTests, tests);
+    cost.sphereTests += tests;
+    return hit;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Bvh.hpp"
+#include "Instrumentation.hpp"
+#include "Intersection.hpp"
+#include "RayPacket.hpp"
+#include "Sphere.hpp"
+#include "SphereSet.hpp"
+#include "Transformations.hpp"
+
+#include <optional>
+
+class Ray;
+
+// Work of one query: spheres tested and BVH nodes visited.
+struct QueryCost
+{
+    std::size_t sphereTests{0};
+    std::size_t bvhNodes{0};
+};
+
+// Spheres plus an optional BVH over them. build() creates the hierarchy,
+// refit() brings it up to date after setTransform() moved spheres. While
+// the hierarchy is missing or out of date, queries test every sphere, so
+// results never depend on it, only their cost does.
+class Scene
+{
+    public:
+        auto add(const Sphere& sphere) -> std::size_t;
+        auto setTransform(std::size_t id, const Transform& transform) -> void;
+        auto build() -> void;
+        auto refit() -> void;
+        auto accelerated() const noexcept -> bool;
+        auto spheres() const noexcept -> const SphereSet&;
+        auto bvh() const noexcept -> const Bvh&;
+        auto intersect(const Ray& ray, Intersections& intersections) const -> void;
+        auto hit(const Ray& ray) const -> std::optional<Intersection>;
+        // same, adding what it took to `cost`
+        auto hit(const Ray& ray, QueryCost& cost) const -> std::optional<Intersection>;
+
+        template<std::size_t lanes>
+        auto intersect(const RayPacket<lanes>& packet, PacketHits<lanes>& hits) const noexcept -> void
+        {
+            if (!accelerated()) {
+                instrument::count(instrument::Counter::sphereTests, _spheres.size()*lanes);
+                _spheres.intersect(packet, hits);
+                return;
+            }
+            std::size_t tests{0};
+            _bvh.intersect(packet, hits, [&](std::size_t id) {
+                ++tests;
+                _spheres[id].intersect(packet, hits, id);
+            });
+            instrument::count(instrument::Counter::sphereTests, tests*lanes);
+        }
+
+    private:
+        SphereSet _spheres;
+        Bvh _bvh;
+        bool _bvhCurrent{false};
+};
@@ -0,0 +1,50 @@
+#include "SceneGenerator.hpp"
+#include "MathConsts.hpp"
+#include "Trace.hpp"
+#include "Transformations.hpp"
+
+#include <cmath>
+#include <random>
+
+namespace
+{
+auto sceneSide(const SceneSpec& spec) -> float
+{
+    return std::cbrt(static_cast<float>(spec.sphereCount));
+}
+
+// uniform in [0, 1); mt19937 output is fixed by the standard, unlike the
+// standard distributions
+auto unitFloat(std::mt19937& generator) -> float
+{
+    return static_cast<float>(generator() >> 8)*0x1p-24f;
+}
+}
+
+auto generateScene(const SceneSpec& spec) -> Scene
+{
+    const trace::Span span{"scene setup"};
+    std::mt19937 generator{spec.seed};
+    const auto side = sceneSide(spec);
+    Scene scene;
+    for (std::size_t i{0}; i < spec.sphereCount; ++i) {
+        const auto r = spec.minRadius + (spec.maxRadius - spec.minRadius)*unitFloat(generator);
+        const auto x = side*(unitFloat(generator) - 0.5f);
+        const auto y = side*(unitFloat(generator) - 0.5f);
+        const auto z = side*(unitFloat(generator) - 0.5f);
+        auto sphere = Sphere();
+        sphere.setTransform(TransformationStacker().scale(r, r, r).translate(x, y, z).getTransform());
+        scene.add(sphere);
+    }
+    return scene;
+}
+
+auto generatedSceneCamera(const SceneSpec& spec, std::size_t hsize, std::size_t vsize) -> Camera
+{
+    const auto side = sceneSide(spec);
+    Camera camera{hsize, vsize, mathConst::pi/3.f};
+    camera.setTransform(view_transform(Point4{0.f, 0.f, -1.5f*side, 1.f},
+                                      Point4{0.f, 0.f, 0.f, 1.f},
+                                      Vec4{0.f, 1.f, 0.f, 0.f}));
+    return camera;
+}
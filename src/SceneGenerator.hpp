@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Camera.hpp"
+#include "Scene.hpp"
+
+#include <cstdint>
+
+// Reproducible scenes of randomly placed spheres for benchmarks. The
+// spheres fill a cube whose volume grows with their count, so a ray sees
+// a similar number of them at every size, and the same seed gives the
+// same scene with every standard library.
+struct SceneSpec
+{
+    std::size_t sphereCount{1000};
+    std::uint32_t seed{42};
+    float minRadius{0.1f};
+    float maxRadius{0.35f};
+};
+
+// spheres are added but the BVH is not built
+auto generateScene(const SceneSpec& spec) -> Scene;
+// looks at the centre of the generated scene from outside of it
+auto generatedSceneCamera(const SceneSpec& spec, std::size_t hsize, std::size_t vsize) -> Camera;
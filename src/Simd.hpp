@@ -0,0 +1,141 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#if defined(RAY_TRACER_SIMD) && defined(__SSE2__)
+#define RAY_TRACER_SIMD_SSE
+#include <emmintrin.h>
+#endif
+
+// Thin 4-lane float abstraction used by Vector<4>, Point<4> and Color.
+// SSE2 backend is selected with RAY_TRACER_SIMD, otherwise a scalar fallback
+// with identical reduction order is used, so both give the same results.
+namespace simd
+{
+#ifdef RAY_TRACER_SIMD_SSE
+inline constexpr auto backend = "sse2";
+
+using Float4 = __m128;
+
+inline auto load(const float* src) -> Float4
+{
+    return _mm_load_ps(src);
+}
+
+inline auto store(float* dst, Float4 value) -> void
+{
+    _mm_store_ps(dst, value);
+}
+
+inline auto broadcast(float value) -> Float4
+{
+    return _mm_set1_ps(value);
+}
+
+inline auto add(Float4 lhs, Float4 rhs) -> Float4
+{
+    return _mm_add_ps(lhs, rhs);
+}
+
+inline auto sub(Float4 lhs, Float4 rhs) -> Float4
+{
+    return _mm_sub_ps(lhs, rhs);
+}
+
+inline auto mul(Float4 lhs, Float4 rhs) -> Float4
+{
+    return _mm_mul_ps(lhs, rhs);
+}
+
+inline auto div(Float4 lhs, Float4 rhs) -> Float4
+{
+    return _mm_div_ps(lhs, rhs);
+}
+
+inline auto negate(Float4 value) -> Float4
+{
+    return _mm_xor_ps(value, _mm_set1_ps(-0.f));
+}
+
+// (l0+l2) + (l1+l3)
+inline auto horizontalSum(Float4 value) -> float
+{
+    const auto pairs = _mm_add_ps(value, _mm_movehl_ps(value, value));
+    const auto sum = _mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, 1));
+    return _mm_cvtss_f32(sum);
+}
+#else
+inline constexpr auto backend = "scalar";
+
+struct Float4
+{
+    std::array<float, 4> lanes;
+};
+
+inline auto load(const float* src) -> Float4
+{
+    return {{src[0], src[1], src[2], src[3]}};
+}
+
+inline auto store(float* dst, Float4 value) -> void
+{
+    for (std::size_t i{0}; i < 4; ++i) {
+        dst[i] = value.lanes[i];
+    }
+}
+
+inline auto broadcast(float value) -> Float4
+{
+    return {{value, value, value, value}};
+}
+
+template<typename Op>
+inline auto laneWise(Float4 lhs, Float4 rhs, Op op) -> Float4
+{
+    for (std::size_t i{0}; i < 4; ++i) {
+        lhs.lanes[i] = op(lhs.lanes[i], rhs.lanes[i]);
+    }
+    return lhs;
+}
+
+inline auto add(Float4 lhs, Float4 rhs) -> Float4
+{
+    return laneWise(lhs, rhs, [](float l, float r){ return l + r; });
+}
+
+inline auto sub(Float4 lhs, Float4 rhs) -> Float4
+{
+    return laneWise(lhs, rhs, [](float l, float r){ return l - r; });
+}
+
+inline auto mul(Float4 lhs, Float4 rhs) -> Float4
+{
+    return laneWise(lhs, rhs, [](float l, float r){ return l * r; });
+}
+
+inline auto div(Float4 lhs, Float4 rhs) -> Float4
+{
+    return laneWise(lhs, rhs, [](float l, float r){ return l / r; });
+}
+
+inline auto negate(Float4 value) -> Float4
+{
+    for (auto& lane: value.lanes) {
+        lane = -lane;
+    }
+    return value;
+}
+
+// (l0+l2) + (l1+l3)
+inline auto horizontalSum(Float4 value) -> float
+{
+    return (value.lanes[0] + value.lanes[2]) + (value.lanes[1] + value.lanes[3]);
+}
+#endif
+
+inline auto dot(Float4 lhs, Float4 rhs) -> float
+{
+    return horizontalSum(mul(lhs, rhs));
+}
+}
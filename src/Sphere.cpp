@@ -4,24 +4,53 @@
 
 #include <algorithm>
 #include <cmath>
+#include <limits>
 
-std::size_t Sphere::counter{0};
-
-auto Sphere::intersect(const Ray& ray) const -> std::vector<float>
+auto Sphere::intersect(const Ray& worldRay, std::size_t id) const -> ObjectIntersections
 {
+    const auto ray = worldRay.transform(_transform.affineInverse());
     const auto sphereToRay = ray.origin() - Point4{0.f, 0.f, 0.f, 1.f};
     const auto a = dotProduct(ray.direction(), ray.direction());
     const auto b = dotProduct(ray.direction(), sphereToRay) * 2.f;
     const auto c = dotProduct(sphereToRay, sphereToRay) - 1.f;
-    const auto discriminant = std::pow(b,2.f)-4*a*c;
+    const auto discriminant = b*b - 4.f*a*c;
+    ObjectIntersections intersections;
     if (discriminant < 0) {
-        return {};
+        return intersections;
+    }
+    intersections.add((-b-std::sqrt(discriminant))/(2.f*a), id);
+    intersections.add((-b+std::sqrt(discriminant))/(2.f*a), id);
+    return intersections;
+}
+
+// The transformed unit sphere reaches sqrt(m0^2 + m1^2 + m2^2) from its
+// center along each axis, m being that axis' row of the linear part. The
+// box is widened by a few ulps so rounding never lets a ray hit the sphere
+// but miss its box.
+auto Sphere::bounds() const -> BoundingBox
+{
+    const auto& m = _transform.affine();
+    BoundingBox box;
+    for (std::size_t axis{0}; axis < 3; ++axis) {
+        const auto extent = std::sqrt(m(axis, 0)*m(axis, 0) + m(axis, 1)*m(axis, 1) + m(axis, 2)*m(axis, 2));
+        const auto margin = 32.f*std::numeric_limits<float>::epsilon()*(std::fabs(m(axis, 3)) + extent);
+        box.min[axis] = m(axis, 3) - extent - margin;
+        box.max[axis] = m(axis, 3) + extent + margin;
     }
-    return {(-b-std::sqrt(discriminant))/2.f*a,
-            (-b+std::sqrt(discriminant))/2.f*a};
+    return box;
+}
+
+auto Sphere::setTransform(const Mat4& matrix) -> void
+{
+    _transform = Transform{matrix};
+}
+
+auto Sphere::setTransform(const Transform& transform) -> void
+{
+    _transform = transform;
 }
 
-auto Sphere::id() const -> std::size_t
+auto Sphere::transform() const -> const Transform&
 {
-    return _id;
+    return _transform;
 }
@@ -1,17 +1,72 @@
 #pragma once
 
+#include "BoundingBox.hpp"
+#include "Intersection.hpp"
+#include "RayPacket.hpp"
+#include "Transformations.hpp"
+
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
-#include <vector>
 
 class Ray;
 
+// Unit sphere placed in the world by its transform. Spheres carry no
+// identity of their own; `id` is the object recorded in the hits, normally
+// the sphere's dense index in a SphereSet.
 class Sphere
 {
     public:
-        auto intersect(const Ray& ray) const -> std::vector<float>;
-        auto id() const -> std::size_t;
+        auto intersect(const Ray& ray, std::size_t id) const -> ObjectIntersections;
+        template<std::size_t lanes>
+        auto intersect(const RayPacket<lanes>& packet, PacketHits<lanes>& hits,
+                       std::size_t id) const noexcept -> void;
+        auto bounds() const -> BoundingBox;
+        auto setTransform(const Mat4& matrix) -> void;
+        auto setTransform(const Transform& transform) -> void;
+        auto transform() const -> const Transform&;
 
     private:
-        static std::size_t counter;
-        const std::size_t _id{counter++};
+        Transform _transform;
 };
+
+// Updates every active lane whose nearest non-negative intersection with
+// this sphere is closer than the one already recorded. Sums follow the
+// order of simd::dot, (x + z) + (y + w), so lanes agree bit for bit with
+// the single ray intersect().
+template<std::size_t lanes>
+auto Sphere::intersect(const RayPacket<lanes>& packet, PacketHits<lanes>& hits,
+                       std::size_t id) const noexcept -> void
+{
+    // local copy, so stores to hits cannot alias it and the loop vectorizes
+    const auto m = _transform.affineInverse();
+    for (std::size_t lane{0}; lane < lanes; ++lane) {
+        const auto px = packet.originX[lane];
+        const auto py = packet.originY[lane];
+        const auto pz = packet.originZ[lane];
+        const auto vx = packet.directionX[lane];
+        const auto vy = packet.directionY[lane];
+        const auto vz = packet.directionZ[lane];
+        const auto ox = (m(0,0)*px + m(0,2)*pz) + (m(0,1)*py + m(0,3));
+        const auto oy = (m(1,0)*px + m(1,2)*pz) + (m(1,1)*py + m(1,3));
+        const auto oz = (m(2,0)*px + m(2,2)*pz) + (m(2,1)*py + m(2,3));
+        const auto dx = (m(0,0)*vx + m(0,2)*vz) + (m(0,1)*vy + m(0,3)*0.f);
+        const auto dy = (m(1,0)*vx + m(1,2)*vz) + (m(1,1)*vy + m(1,3)*0.f);
+        const auto dz = (m(2,0)*vx + m(2,2)*vz) + (m(2,1)*vy + m(2,3)*0.f);
+
+        const auto a = (dx*dx + dz*dz) + (dy*dy + 0.f);
+        const auto b = ((dx*ox + dz*oz) + (dy*oy + 0.f)) * 2.f;
+        const auto c = ((ox*ox + oz*oz) + (oy*oy + 0.f)) - 1.f;
+        const auto discriminant = b*b - 4.f*a*c;
+        const auto root = std::sqrt(std::max(discriminant, 0.f));
+        const auto t0 = (-b - root)/(2.f*a);
+        const auto t1 = (-b + root)/(2.f*a);
+        const auto t = t0 >= 0.f ? t0 : t1;
+        // non short-circuiting & keeps the loop free of branches; a tie
+        // goes to the lower id whatever order spheres are visited in
+        const auto closer = (packet.active[lane] != 0) & (discriminant >= 0.f) & (t >= 0.f) &
+                            ((t < hits.t[lane]) | ((t == hits.t[lane]) & (id < hits.object[lane])));
+        hits.t[lane] = closer ? t : hits.t[lane];
+        hits.object[lane] = closer ? id : hits.object[lane];
+    }
+}
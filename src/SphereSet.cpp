@@ -0,0 +1,208 @@
+#include "SphereSet.hpp"
+#include "Affine.hpp"
+#include "Ray.hpp"
+#include "Utilities.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace
+{
+// Largest factor by which the linear part of `matrix` stretches a vector,
+// i.e. its spectral norm, from the largest eigenvalue of L*L^T.
+auto largestScale(const Affine3& matrix) -> float
+{
+    std::array<std::array<double, 3>, 3> a{};
+    for (std::size_t r{0}; r < 3; ++r) {
+        for (std::size_t c{0}; c < 3; ++c) {
+            for (std::size_t k{0}; k < 3; ++k) {
+                a[r][c] += static_cast<double>(matrix(r, k))*static_cast<double>(matrix(c, k));
+            }
+        }
+    }
+    const auto offDiagonal = a[0][1]*a[0][1] + a[0][2]*a[0][2] + a[1][2]*a[1][2];
+    const auto q = (a[0][0] + a[1][1] + a[2][2])/3.0;
+    const auto p2 = (a[0][0] - q)*(a[0][0] - q) + (a[1][1] - q)*(a[1][1] - q) +
+                    (a[2][2] - q)*(a[2][2] - q) + 2.0*offDiagonal;
+    if (p2 <= 0.0) {
+        return static_cast<float>(std::sqrt(std::max(q, 0.0)));
+    }
+    // closed form for symmetric 3x3 matrices: eigenvalues of B = (A - qI)/p
+    // are 2cos(phi + 2k*pi/3) with cos(3phi) = det(B)/2
+    const auto p = std::sqrt(p2/6.0);
+    std::array<std::array<double, 3>, 3> b{};
+    for (std::size_t r{0}; r < 3; ++r) {
+        for (std::size_t c{0}; c < 3; ++c) {
+            b[r][c] = (a[r][c] - (r == c ? q : 0.0))/p;
+        }
+    }
+    const auto halfDeterminant = (b[0][0]*(b[1][1]*b[2][2] - b[1][2]*b[2][1]) -
+                                  b[0][1]*(b[1][0]*b[2][2] - b[1][2]*b[2][0]) +
+                                  b[0][2]*(b[1][0]*b[2][1] - b[1][1]*b[2][0]))/2.0;
+    const auto phi = std::acos(std::clamp(halfDeterminant, -1.0, 1.0))/3.0;
+    return static_cast<float>(std::sqrt(q + 2.0*p*std::cos(phi)));
+}
+}
+
+auto SphereSet::add(const Sphere& sphere) -> std::size_t
+{
+    const auto id = _spheres.size();
+    if (id == std::numeric_limits<std::uint32_t>::max()) {
+        throw std::runtime_error("SphereSet is full");
+    }
+    _spheres.push_back(sphere);
+    if (id % width == 0) {
+        for (auto& coefficients: _inverse) {
+            coefficients.resize(id + width, 0.f);
+        }
+    }
+    store(id);
+    return id;
+}
+
+auto SphereSet::setTransform(std::size_t id, const Transform& transform) -> void
+{
+    if (id >= _spheres.size()) {
+        throw std::runtime_error("Sphere id out of range");
+    }
+    _spheres[id].setTransform(transform);
+    store(id);
+}
+
+// copies the transform of sphere `id` into the arrays
+auto SphereSet::store(std::size_t id) -> void
+{
+    const auto& inverse = _spheres[id].transform().affineInverse();
+    for (std::size_t r{0}; r < Affine3::rows; ++r) {
+        for (std::size_t c{0}; c < Affine3::columns; ++c) {
+            _inverse[r*Affine3::columns + c][id] = inverse(r, c);
+        }
+    }
+}
+
+auto SphereSet::size() const noexcept -> std::size_t
+{
+    return _spheres.size();
+}
+
+auto SphereSet::empty() const noexcept -> bool
+{
+    return _spheres.empty();
+}
+
+auto SphereSet::operator[](std::size_t id) const noexcept -> const Sphere&
+{
+    RAY_TRACER_ASSERT_INDEX(id < _spheres.size());
+    return _spheres[id];
+}
+
+auto SphereSet::center(std::size_t id) const noexcept -> Point4
+{
+    RAY_TRACER_ASSERT_INDEX(id < _spheres.size());
+    const auto& matrix = _spheres[id].transform().affine();
+    return Point4{matrix(0, 3), matrix(1, 3), matrix(2, 3), 1.f};
+}
+
+auto SphereSet::radius(std::size_t id) const noexcept -> float
+{
+    RAY_TRACER_ASSERT_INDEX(id < _spheres.size());
+    return largestScale(_spheres[id].transform().affine());
+}
+
+auto SphereSet::bounds() const -> std::vector<BoundingBox>
+{
+    std::vector<BoundingBox> boxes;
+    boxes.reserve(_spheres.size());
+    for (const auto& sphere: _spheres) {
+        boxes.push_back(sphere.bounds());
+    }
+    return boxes;
+}
+
+auto SphereSet::intersect(const Ray& ray, Intersections& intersections) const -> void
+{
+    for (std::size_t id{0}; id < _spheres.size(); ++id) {
+        intersections.add(_spheres[id].intersect(ray, id));
+    }
+}
+
+// nearest non-negative intersection with sphere `id`, as Intersections::hit() picks it
+auto SphereSet::nearest(const Ray& ray, std::size_t id) const -> std::optional<float>
+{
+    RAY_TRACER_ASSERT_INDEX(id < _spheres.size());
+    std::optional<float> nearest;
+    for (const auto& intersection: _spheres[id].intersect(ray, id)) {
+        if (intersection.t >= 0.f && (!nearest || intersection.t < *nearest)) {
+            nearest = intersection.t;
+        }
+    }
+    return nearest;
+}
+
+// Same arithmetic, in the same order, as Sphere::intersect() followed by
+// Intersections::hit(), so both agree bit for bit, including which sphere
+// wins a tie. Each of the `width` lanes keeps its own nearest hit over the
+// spheres id % width == lane; the lanes are reduced once at the end.
+auto SphereSet::nearest(const Ray& ray) const noexcept -> std::optional<Intersection>
+{
+    const auto px = ray.origin()[0];
+    const auto py = ray.origin()[1];
+    const auto pz = ray.origin()[2];
+    const auto vx = ray.direction()[0];
+    const auto vy = ray.direction()[1];
+    const auto vz = ray.direction()[2];
+    // plain pointers, so stores to the lane results cannot alias them
+    std::array<const float*, 12> m{};
+    for (std::size_t k{0}; k < m.size(); ++k) {
+        m[k] = _inverse[k].data();
+    }
+    const auto count = static_cast<std::uint32_t>(_spheres.size());
+    const auto padded = _inverse[0].size();
+    constexpr auto infinity = std::numeric_limits<float>::infinity();
+
+    alignas(32) std::array<float, width> nearestT;
+    alignas(32) std::array<std::uint32_t, width> nearestId{};
+    nearestT.fill(infinity);
+    for (std::size_t block{0}; block < padded; block += width) {
+        for (std::size_t lane{0}; lane < width; ++lane) {
+            const auto i = block + lane;
+            const auto id = static_cast<std::uint32_t>(i);
+            const auto ox = (m[0][i]*px + m[2][i]*pz) + (m[1][i]*py + m[3][i]);
+            const auto oy = (m[4][i]*px + m[6][i]*pz) + (m[5][i]*py + m[7][i]);
+            const auto oz = (m[8][i]*px + m[10][i]*pz) + (m[9][i]*py + m[11][i]);
+            const auto dx = (m[0][i]*vx + m[2][i]*vz) + (m[1][i]*vy + m[3][i]*0.f);
+            const auto dy = (m[4][i]*vx + m[6][i]*vz) + (m[5][i]*vy + m[7][i]*0.f);
+            const auto dz = (m[8][i]*vx + m[10][i]*vz) + (m[9][i]*vy + m[11][i]*0.f);
+
+            const auto a = (dx*dx + dz*dz) + (dy*dy + 0.f);
+            const auto b = ((dx*ox + dz*oz) + (dy*oy + 0.f)) * 2.f;
+            const auto c = ((ox*ox + oz*oz) + (oy*oy + 0.f)) - 1.f;
+            const auto discriminant = b*b - 4.f*a*c;
+            const auto root = std::sqrt(std::max(discriminant, 0.f));
+            const auto t0 = (-b - root)/(2.f*a);
+            const auto t1 = (-b + root)/(2.f*a);
+            const auto t = t0 >= 0.f ? t0 : t1;
+            // padding lanes past `count` hold zeros and are masked out here
+            const auto valid = (id < count) & (discriminant >= 0.f) & (t >= 0.f);
+            const auto candidate = valid ? t : infinity;
+            // blend through a mask, SSE2 has no select for the id lanes
+            const auto closer = 0u - static_cast<std::uint32_t>(candidate < nearestT[lane]);
+            nearestT[lane] = std::min(candidate, nearestT[lane]);
+            nearestId[lane] = (id & closer) | (nearestId[lane] & ~closer);
+        }
+    }
+
+    std::optional<Intersection> hit;
+    for (std::size_t lane{0}; lane < width; ++lane) {
+        if (nearestT[lane] == infinity) {
+            continue;
+        }
+        if (!hit || nearestT[lane] < hit->t ||
+            (nearestT[lane] == hit->t && nearestId[lane] < hit->object)) {
+            hit = Intersection{nearestT[lane], nearestId[lane]};
+        }
+    }
+    return hit;
+}
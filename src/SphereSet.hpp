@@ -0,0 +1,55 @@
+#pragma once
+
+#include "BoundingBox.hpp"
+#include "Intersection.hpp"
+#include "Point.hpp"
+#include "RayPacket.hpp"
+#include "Sphere.hpp"
+#include "Transformations.hpp"
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+class Ray;
+
+// Spheres stored as structure-of-arrays. A sphere's id is its dense index
+// in the set. Next to the spheres themselves the set keeps every inverse
+// transform coefficient in its own array, padded to a multiple of `width`,
+// so nearest() tests one ray against `width` spheres per loop iteration.
+// center() and radius(), the world space sphere enclosing one of them, are
+// derived from its transform when asked for; no kernel reads them.
+class SphereSet
+{
+    public:
+        static constexpr std::size_t width{8};
+
+        auto add(const Sphere& sphere) -> std::size_t;
+        auto setTransform(std::size_t id, const Transform& transform) -> void;
+        auto size() const noexcept -> std::size_t;
+        auto empty() const noexcept -> bool;
+        auto operator[](std::size_t id) const noexcept -> const Sphere&;
+        auto center(std::size_t id) const noexcept -> Point4;
+        auto radius(std::size_t id) const noexcept -> float;
+        auto bounds() const -> std::vector<BoundingBox>;
+
+        auto intersect(const Ray& ray, Intersections& intersections) const -> void;
+        auto nearest(const Ray& ray) const noexcept -> std::optional<Intersection>;
+        auto nearest(const Ray& ray, std::size_t id) const -> std::optional<float>;
+
+        template<std::size_t lanes>
+        auto intersect(const RayPacket<lanes>& packet, PacketHits<lanes>& hits) const noexcept -> void
+        {
+            for (std::size_t id{0}; id < _spheres.size(); ++id) {
+                _spheres[id].intersect(packet, hits, id);
+            }
+        }
+
+    private:
+        auto store(std::size_t id) -> void;
+
+        std::vector<Sphere> _spheres;
+        // row major coefficients of the inverse transforms, _inverse[r*4 + c][id]
+        std::array<std::vector<float>, 12> _inverse;
+};
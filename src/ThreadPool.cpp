@@ -0,0 +1,156 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace
+{
+constexpr auto pack(std::uint64_t begin, std::uint64_t end) noexcept -> std::uint64_t
+{
+    return begin << 32 | end;
+}
+
+constexpr auto begin(std::uint64_t range) noexcept -> std::uint32_t
+{
+    return static_cast<std::uint32_t>(range >> 32);
+}
+
+constexpr auto end(std::uint64_t range) noexcept -> std::uint32_t
+{
+    return static_cast<std::uint32_t>(range);
+}
+}
+
+ThreadPool::ThreadPool(std::size_t threads):
+    _shares{std::make_unique<Share[]>(std::max<std::size_t>(threads, 1))},
+    _size{std::max<std::size_t>(threads, 1)}
+{
+    _threads.reserve(_size - 1);
+    for (std::size_t worker{1}; worker < _size; ++worker) {
+        _threads.emplace_back([this, worker]() { workerLoop(worker); });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock{_mutex};
+        _stopping = true;
+    }
+    _wake.notify_all();
+    for (auto& thread: _threads) {
+        thread.join();
+    }
+}
+
+auto ThreadPool::defaultThreadCount() -> std::size_t
+{
+    return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+auto ThreadPool::size() const noexcept -> std::size_t
+{
+    return _size;
+}
+
+auto ThreadPool::run(std::size_t count, const std::function<void(std::size_t)>& task) -> void
+{
+    if (count > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::runtime_error("Too many tasks for one batch");
+    }
+    for (std::size_t worker{0}; worker < _size; ++worker) {
+        _shares[worker].range.store(pack(count*worker/_size, count*(worker + 1)/_size),
+                                    std::memory_order_relaxed);
+    }
+    {
+        std::lock_guard lock{_mutex};
+        _task = &task;
+        _error = nullptr;
+        _busy = _threads.size();
+        ++_generation;
+    }
+    _wake.notify_all();
+
+    work(0);
+
+    std::unique_lock lock{_mutex};
+    _finished.wait(lock, [this]() { return _busy == 0; });
+    _task = nullptr;
+    if (_error) {
+        std::rethrow_exception(std::exchange(_error, nullptr));
+    }
+}
+
+auto ThreadPool::workerLoop(std::size_t self) -> void
+{
+    std::uint64_t seen{0};
+    while (true) {
+        {
+            std::unique_lock lock{_mutex};
+            _wake.wait(lock, [&]() { return _stopping || _generation != seen; });
+            if (_stopping) {
+                return;
+            }
+            seen = _generation;
+        }
+        work(self);
+        {
+            std::lock_guard lock{_mutex};
+            --_busy;
+        }
+        _finished.notify_one();
+    }
+}
+
+auto ThreadPool::work(std::size_t self) -> void
+{
+    while (const auto index = take(self)) {
+        try {
+            (*_task)(*index);
+        } catch (...) {
+            std::lock_guard lock{_mutex};
+            if (!_error) {
+                _error = std::current_exception();
+            }
+        }
+    }
+}
+
+// Next index from the own share, or from a victim once that is empty;
+// visiting victims in order from self + 1 spreads thieves over the pool.
+auto ThreadPool::take(std::size_t self) noexcept -> std::optional<std::uint32_t>
+{
+    auto& own = _shares[self].range;
+    auto range = own.load(std::memory_order_acquire);
+    while (begin(range) < end(range)) {
+        if (own.compare_exchange_weak(range, pack(begin(range) + 1u, end(range)),
+                                      std::memory_order_acq_rel)) {
+            return begin(range);
+        }
+    }
+    for (std::size_t offset{1}; offset < _size; ++offset) {
+        if (const auto index = steal(self, (self + offset) % _size)) {
+            return index;
+        }
+    }
+    return std::nullopt;
+}
+
+// Moves the back half of the victim's share, at least one index, into the
+// empty own share and returns the first of the stolen indices.
+auto ThreadPool::steal(std::size_t self, std::size_t victim) noexcept -> std::optional<std::uint32_t>
+{
+    auto& theirs = _shares[victim].range;
+    auto range = theirs.load(std::memory_order_acquire);
+    while (begin(range) < end(range)) {
+        const auto middle = begin(range) + (end(range) - begin(range))/2u;
+        if (theirs.compare_exchange_weak(range, pack(begin(range), middle),
+                                         std::memory_order_acq_rel)) {
+            _shares[self].range.store(pack(middle + 1u, end(range)), std::memory_order_release);
+            return middle;
+        }
+    }
+    return std::nullopt;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+// Fixed set of workers running batches of indexed tasks. run() hands every
+// worker a contiguous share of the indices; a worker takes its own from the
+// front and, once out of work, steals the back half of another worker's
+// share. Shares are single atomic words, so neither taking nor stealing
+// locks. The calling thread works as well, so a pool of one thread runs
+// everything inline.
+class ThreadPool
+{
+    public:
+        explicit ThreadPool(std::size_t threads = defaultThreadCount());
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        auto operator=(const ThreadPool&) -> ThreadPool& = delete;
+
+        static auto defaultThreadCount() -> std::size_t;
+
+        auto size() const noexcept -> std::size_t;
+        // Calls task(i) for every i in [0, count) and returns once all are
+        // done. The first exception thrown by a task is rethrown here.
+        auto run(std::size_t count, const std::function<void(std::size_t)>& task) -> void;
+
+    private:
+        // [begin, end) packed as begin << 32 | end, on its own cache line
+        struct alignas(64) Share
+        {
+            std::atomic<std::uint64_t> range{0};
+        };
+
+        auto workerLoop(std::size_t self) -> void;
+        auto work(std::size_t self) -> void;
+        auto take(std::size_t self) noexcept -> std::optional<std::uint32_t>;
+        auto steal(std::size_t self, std::size_t victim) noexcept -> std::optional<std::uint32_t>;
+
+        std::unique_ptr<Share[]> _shares;
+        std::size_t _size;
+        std::vector<std::thread> _threads;
+
+        std::mutex _mutex;
+        std::condition_variable _wake;
+        std::condition_variable _finished;
+        const std::function<void(std::size_t)>* _task{nullptr};
+        std::uint64_t _generation{0};
+        std::size_t _busy{0};
+        bool _stopping{false};
+        std::exception_ptr _error;
+};
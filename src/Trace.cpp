@@ -0,0 +1,193 @@
+#include "Trace.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+namespace trace
+{
+namespace
+{
+// spans a thread can record per recording; later ones are counted as
+// dropped
+constexpr std::size_t spanCapacity{std::size_t{1} << 16};
+
+struct Event
+{
+    const char* name;
+    std::int64_t index;
+    std::uint64_t begin;
+    std::uint64_t end;
+};
+
+// Written only by its thread: events[count] is filled in, then count is
+// published. stop() reads the first count events of buffers stamped with
+// the current recording and ignores anything appended afterwards. A
+// thread empties its buffer itself on its first span of a new recording.
+struct Buffer
+{
+    std::size_t thread{0};
+    std::unique_ptr<Event[]> events;
+    std::atomic<std::uint64_t> recording{0};
+    std::atomic<std::size_t> count{0};
+    std::atomic<std::size_t> dropped{0};
+};
+
+// buffers outlive their threads, so spans of finished threads are kept
+struct Registry
+{
+    std::mutex mutex;
+    std::deque<Buffer> buffers;
+    std::atomic<bool> recording{false};
+    // numbers the recordings, starting at 1
+    std::atomic<std::uint64_t> current{0};
+    std::uint64_t epoch{0};
+};
+
+auto registry() -> Registry&
+{
+    static Registry instance;
+    return instance;
+}
+
+auto now() noexcept -> std::uint64_t
+{
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+thread_local Buffer* local{nullptr};
+
+// the calling thread's buffer, registered on first use; null when that
+// fails for lack of memory
+auto buffer() noexcept -> Buffer*
+{
+    if (local == nullptr) {
+        try {
+            auto events = std::make_unique<Event[]>(spanCapacity);
+            auto& instance = registry();
+            const std::lock_guard lock{instance.mutex};
+            local = &instance.buffers.emplace_back();
+            local->thread = instance.buffers.size() - 1;
+            local->events = std::move(events);
+        } catch (const std::exception&) {
+            return nullptr;
+        }
+    }
+    return local;
+}
+
+// microseconds since the start of the recording
+auto microseconds(std::uint64_t time, std::uint64_t epoch) -> double
+{
+    return time < epoch ? 0.0 : static_cast<double>(time - epoch)*1e-3;
+}
+}
+
+auto start() -> void
+{
+    auto& instance = registry();
+    const std::lock_guard lock{instance.mutex};
+    instance.epoch = now();
+    instance.current.fetch_add(1, std::memory_order_acq_rel);
+    instance.recording.store(true, std::memory_order_release);
+}
+
+auto stop(const std::filesystem::path& filePath) -> void
+{
+    auto& instance = registry();
+    const std::lock_guard lock{instance.mutex};
+    instance.recording.store(false, std::memory_order_relaxed);
+    const auto current = instance.current.load(std::memory_order_relaxed);
+    std::ofstream file{filePath, std::ios::binary};
+    if (!file) {
+        throw std::runtime_error("Cannot open/create file");
+    }
+    file << "{\"traceEvents\": [";
+    char line[256];
+    auto separator = "\n";
+    std::size_t dropped{0};
+    for (const auto& entry: instance.buffers) {
+        if (entry.recording.load(std::memory_order_acquire) != current) {
+            continue;
+        }
+        const auto count = entry.count.load(std::memory_order_acquire);
+        dropped += entry.dropped.load(std::memory_order_relaxed);
+        if (count == 0) {
+            continue;
+        }
+        std::snprintf(line, sizeof(line),
+                      "%s{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %zu, "
+                      "\"args\": {\"name\": \"thread %zu\"}}",
+                      separator, entry.thread, entry.thread);
+        file << line;
+        separator = ",\n";
+        for (std::size_t i{0}; i < count; ++i) {
+            const auto& event = entry.events[i];
+            const auto begin = microseconds(event.begin, instance.epoch);
+            std::snprintf(line, sizeof(line),
+                          ",\n{\"name\": \"%s\", \"cat\": \"ray_tracer\", \"ph\": \"X\", \"pid\": 1, \"tid\": %zu, "
+                          "\"ts\": %.3f, \"dur\": %.3f",
+                          event.name, entry.thread, begin, microseconds(event.end, instance.epoch) - begin);
+            file << line;
+            if (event.index >= 0) {
+                file << ", \"args\": {\"index\": " << event.index << '}';
+            }
+            file << '}';
+        }
+    }
+    file << "\n], \"displayTimeUnit\": \"ms\", \"otherData\": {\"droppedSpans\": " << dropped << "}}\n";
+    if (!file) {
+        throw std::runtime_error("Cannot write file");
+    }
+}
+
+auto recording() noexcept -> bool
+{
+    return registry().recording.load(std::memory_order_acquire);
+}
+
+// The buffer is registered here, so the destructor never allocates.
+Span::Span(const char* name, std::int64_t index) noexcept:
+    _name{nullptr},
+    _index{index},
+    _recording{0},
+    _begin{0}
+{
+    if (recording() && buffer() != nullptr) {
+        _name = name;
+        _recording = registry().current.load(std::memory_order_acquire);
+        _begin = now();
+    }
+}
+
+Span::~Span()
+{
+    if (_name == nullptr) {
+        return;
+    }
+    const auto end = now();
+    auto& own = *local;
+    if (registry().current.load(std::memory_order_acquire) != _recording) {
+        // a new recording started meanwhile
+        return;
+    }
+    if (own.recording.load(std::memory_order_relaxed) != _recording) {
+        own.count.store(0, std::memory_order_relaxed);
+        own.dropped.store(0, std::memory_order_relaxed);
+        own.recording.store(_recording, std::memory_order_release);
+    }
+    const auto count = own.count.load(std::memory_order_relaxed);
+    if (count == spanCapacity) {
+        own.dropped.store(own.dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return;
+    }
+    own.events[count] = Event{_name, _index, _begin, end};
+    own.count.store(count + 1, std::memory_order_release);
+}
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+
+// Timeline of spans in the Chrome trace-event format, which
+// chrome://tracing and ui.perfetto.dev open: one track per thread, so
+// load imbalance between render threads, idle workers and stalls while
+// saving show up directly. Every thread appends to a fixed size buffer of
+// its own without locking and publishes each span with an atomic count,
+// up to which stop() reads; start() and stop() belong between frames,
+// like instrument::collect(). Spans outside a recording cost one atomic
+// load.
+namespace trace
+{
+// Drops the spans of an earlier recording and starts a new one.
+auto start() -> void;
+// Ends the recording and writes its spans to a JSON file.
+auto stop(const std::filesystem::path& filePath) -> void;
+auto recording() noexcept -> bool;
+
+// Records its lifetime on the calling thread. The name must outlive the
+// recording, a string literal in practice; a non negative index is shown
+// as an argument of the span, e.g. the number of a tile.
+class Span
+{
+    public:
+        explicit Span(const char* name, std::int64_t index = -1) noexcept;
+        ~Span();
+
+        Span(const Span&) = delete;
+        auto operator=(const Span&) -> Span& = delete;
+
+    private:
+        // null when not recording
+        const char* _name;
+        std::int64_t _index;
+        std::uint64_t _recording;
+        std::uint64_t _begin;
+};
+}
@@ -1,25 +1,218 @@
 #pragma once
 
+#include "Affine.hpp"
 #include "Matrix.hpp"
 
-auto translation(float x, float y, float z) -> Mat4;
-auto scaling(float x, float y, float z) -> Mat4;
+#include <stdexcept>
+
+constexpr auto translation(float x, float y, float z) -> Mat4
+{
+    auto temp = matrix::identity4;
+    temp(0,3) = x;
+    temp(1,3) = y;
+    temp(2,3) = z;
+    return temp;
+}
+
+constexpr auto scaling(float x, float y, float z) -> Mat4
+{
+    auto temp = matrix::identity4;
+    temp(0,0) = x;
+    temp(1,1) = y;
+    temp(2,2) = z;
+    return temp;
+}
+
+// Rotations by an angle given through its cosine and sine; usable in
+// constant expressions when those are known up front.
+constexpr auto rotation_x(float cosine, float sine) -> Mat4
+{
+    auto temp = matrix::identity4;
+    temp(1,1) = cosine;
+    temp(1,2) = -sine;
+    temp(2,1) = sine;
+    temp(2,2) = cosine;
+    return temp;
+}
+
+constexpr auto rotation_y(float cosine, float sine) -> Mat4
+{
+    auto temp = matrix::identity4;
+    temp(0,0) = cosine;
+    temp(0,2) = sine;
+    temp(2,0) = -sine;
+    temp(2,2) = cosine;
+    return temp;
+}
+
+constexpr auto rotation_z(float cosine, float sine) -> Mat4
+{
+    auto temp = matrix::identity4;
+    temp(0,0) = cosine;
+    temp(0,1) = -sine;
+    temp(1,0) = sine;
+    temp(1,1) = cosine;
+    return temp;
+}
+
+constexpr auto shearing(float x_y,float x_z,float y_x,float y_z,float z_x,float z_y) -> Mat4
+{
+    auto temp = matrix::identity4;
+    temp(0,1) = x_y;
+    temp(0,2) = x_z;
+    temp(1,0) = y_x;
+    temp(1,2) = y_z;
+    temp(2,0) = z_x;
+    temp(2,1) = z_y;
+    return temp;
+}
+
 auto rotation_x(float rad) -> Mat4;
 auto rotation_y(float rad) -> Mat4;
 auto rotation_z(float rad) -> Mat4;
-auto shearing(float x_y,float x_z,float y_x,float y_z,float z_x,float z_y) -> Mat4;
+auto view_transform(const Point4& from, const Point4& to, const Vec4& up) -> Mat4;
+
+// Affine transformation stored together with its inverse, so objects pay
+// for the inversion once instead of on every intersection. Both are kept as
+// Affine3 and expanded to Mat4 only on request.
+class Transform
+{
+    public:
+        constexpr Transform() = default;
+
+        constexpr explicit Transform(const Mat4& matrix):
+            _matrix{checkedAffine(matrix)},
+            _inverse{::inverse(_matrix)}
+        {}
+
+        constexpr Transform(const Affine3& matrix, const Affine3& inverse):
+            _matrix{matrix},
+            _inverse{inverse}
+        {}
+
+        constexpr auto matrix() const -> Mat4
+        {
+            return _matrix.toMatrix();
+        }
 
+        constexpr auto inverse() const -> Mat4
+        {
+            return _inverse.toMatrix();
+        }
+
+        constexpr auto affine() const -> const Affine3&
+        {
+            return _matrix;
+        }
+
+        constexpr auto affineInverse() const -> const Affine3&
+        {
+            return _inverse;
+        }
+
+    private:
+        static constexpr auto checkedAffine(const Mat4& matrix) -> Affine3
+        {
+            if (!isAffine(matrix)) {
+                throw std::runtime_error("Transform requires an affine matrix");
+            }
+            return Affine3{matrix};
+        }
+
+        Affine3 _matrix;
+        Affine3 _inverse;
+};
+
+// Composes transformations right to left (last call is applied last) in
+// affine form; translations, scalings and rotations only touch the rows
+// they change. Tracks whether the result is rigid, so its inverse can be
+// taken by transposition; a (cosine, sine) pair that is not unit length
+// scales as well as rotates and clears that flag.
 class TransformationStacker
 {
     public:
-        auto translate(float x, float y, float z) -> TransformationStacker&;
-        auto scale(float x, float y, float z) -> TransformationStacker&;
+        constexpr auto translate(float x, float y, float z) -> TransformationStacker&
+        {
+            _matrix(0,3) += x;
+            _matrix(1,3) += y;
+            _matrix(2,3) += z;
+            return *this;
+        }
+
+        constexpr auto scale(float x, float y, float z) -> TransformationStacker&
+        {
+            for (std::size_t column{0}; column < Affine3::columns; ++column) {
+                _matrix(0,column) *= x;
+                _matrix(1,column) *= y;
+                _matrix(2,column) *= z;
+            }
+            _rigid = false;
+            return *this;
+        }
+
+        constexpr auto rotate_x(float cosine, float sine) -> TransformationStacker&
+        {
+            rotateRows(1, 2, cosine, sine);
+            return *this;
+        }
+
+        constexpr auto rotate_y(float cosine, float sine) -> TransformationStacker&
+        {
+            rotateRows(2, 0, cosine, sine);
+            return *this;
+        }
+
+        constexpr auto rotate_z(float cosine, float sine) -> TransformationStacker&
+        {
+            rotateRows(0, 1, cosine, sine);
+            return *this;
+        }
+
+        constexpr auto shear(float x_y,float x_z,float y_x,float y_z,float z_x,float z_y) -> TransformationStacker&
+        {
+            _matrix = Affine3{shearing(x_y, x_z, y_x, y_z, z_x, z_y)}*_matrix;
+            _rigid = false;
+            return *this;
+        }
+
         auto rotate_x(float rad) -> TransformationStacker&;
         auto rotate_y(float rad) -> TransformationStacker&;
         auto rotate_z(float rad) -> TransformationStacker&;
-        auto shear(float x_y,float x_z,float y_x,float y_z,float z_x,float z_y) -> TransformationStacker&;
-        auto getMatrix() -> Mat4;
+
+        constexpr auto getMatrix() const -> Mat4
+        {
+            return _matrix.toMatrix();
+        }
+
+        constexpr auto getAffine() const -> const Affine3&
+        {
+            return _matrix;
+        }
+
+        constexpr auto getTransform() const -> Transform
+        {
+            return Transform{_matrix, _rigid ? rigidInverse(_matrix) : inverse(_matrix)};
+        }
 
     private:
-        Mat4 _matrix{matrix::identity4};
+        // left multiplication by a rotation mixing only rows first and second
+        constexpr auto rotateRows(std::size_t first, std::size_t second, float cosine, float sine) -> void
+        {
+            for (std::size_t column{0}; column < Affine3::columns; ++column) {
+                const auto a = _matrix(first, column);
+                const auto b = _matrix(second, column);
+                _matrix(first, column) = cosine*a - sine*b;
+                _matrix(second, column) = sine*a + cosine*b;
+            }
+            const auto lengthError = cosine*cosine + sine*sine - 1.f;
+            if (lengthError > unitTolerance || lengthError < -unitTolerance) {
+                _rigid = false;
+            }
+        }
+
+        // float cos/sin pairs land within a few ulp of unit length
+        static constexpr float unitTolerance{1e-5f};
+
+        Affine3 _matrix;
+        bool _rigid{true};
 };
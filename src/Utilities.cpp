@@ -13,5 +13,5 @@ auto relativelyEqual(float a,
 
 auto roundUp(float number) -> float
 {
-    return std::ceil(number*10e5)/10e5;
+    return std::ceil(number*10e5f)/10e5f;
 }
@@ -4,6 +4,21 @@
 #include <cstdint>
 #include <limits>
 
+// Unchecked element access (operator[], get<>, data()) is only validated
+// when the build enables CHECKED_ACCESS, independently of NDEBUG; at()
+// always throws.
+#ifdef RAY_TRACER_CHECKED_ACCESS
+#include <cstdio>
+#include <cstdlib>
+#define RAY_TRACER_ASSERT_INDEX(condition)                                   \
+    ((condition) ? static_cast<void>(0)                                      \
+                 : (std::fprintf(stderr, "%s:%d: index check failed: %s\n", \
+                                 __FILE__, __LINE__, #condition),            \
+                    std::abort()))
+#else
+#define RAY_TRACER_ASSERT_INDEX(condition) static_cast<void>(0)
+#endif
+
 auto relativelyEqual(float a,
                      float b,
                      float maxRelativeDiff =
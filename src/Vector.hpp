@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Point.hpp"
+#include "Simd.hpp"
 #include "Utilities.hpp"
 
 #include <algorithm>
@@ -30,29 +31,44 @@ class Vector
             if(values.size() > size) {
                 throw std::runtime_error("Too many elements");
             }
-            std::copy(values.begin(), values.end(), _coordinates.begin());
+            std::size_t index{0};
+            for (const auto value: values) {
+                _coordinates[index++] = value;
+            }
         }
     
         auto& operator+=(const Vector<size>& rhs)
         {
-            for (std::size_t i{0}; i < size; ++i) {
-                _coordinates[i] += rhs._coordinates[i];
+            if constexpr (size == 4) {
+                simd::store(data(), simd::add(simd::load(data()), simd::load(rhs.data())));
+            } else {
+                for (std::size_t i{0}; i < size; ++i) {
+                    _coordinates[i] += rhs._coordinates[i];
+                }
             }
             return *this;
         }
 
         auto& operator-=(const Vector<size>& rhs)
         {
-            for (std::size_t i{0}; i < size; ++i) {
-                _coordinates[i] -= rhs._coordinates[i];
+            if constexpr (size == 4) {
+                simd::store(data(), simd::sub(simd::load(data()), simd::load(rhs.data())));
+            } else {
+                for (std::size_t i{0}; i < size; ++i) {
+                    _coordinates[i] -= rhs._coordinates[i];
+                }
             }
             return *this;
         }
 
         auto& operator*=(float scalar)
         {
-            std::for_each(_coordinates.begin(), _coordinates.end(),
-                          [scalar](auto& el){ el*=scalar; });
+            if constexpr (size == 4) {
+                simd::store(data(), simd::mul(simd::load(data()), simd::broadcast(scalar)));
+            } else {
+                std::for_each(_coordinates.begin(), _coordinates.end(),
+                              [scalar](auto& el){ el*=scalar; });
+            }
             return *this;
         }
 
@@ -77,10 +93,47 @@ class Vector
             return _coordinates[position];
         }
 
+        constexpr auto& operator[](std::size_t position) const noexcept
+        {
+            RAY_TRACER_ASSERT_INDEX(position < size);
+            return _coordinates[position];
+        }
+
+        constexpr auto& operator[](std::size_t position) noexcept
+        {
+            RAY_TRACER_ASSERT_INDEX(position < size);
+            return _coordinates[position];
+        }
+
+        template<std::size_t position>
+        constexpr auto& get() const noexcept
+        {
+            static_assert(position < size, "Index out of bounds");
+            return std::get<position>(_coordinates);
+        }
+
+        template<std::size_t position>
+        constexpr auto& get() noexcept
+        {
+            static_assert(position < size, "Index out of bounds");
+            return std::get<position>(_coordinates);
+        }
+
+        auto data() const noexcept -> const float*
+        {
+            return _coordinates.data();
+        }
+
+        auto data() noexcept -> float*
+        {
+            return _coordinates.data();
+        }
+
         auto cross(const Vector<size>& rhs) -> Vector<size>&;
 
     private:
-        std::array<float, size> _coordinates{};
+        // 4-component vectors are kept 16-byte aligned for the simd kernels
+        alignas(size == 4 ? 16 : alignof(float)) std::array<float, size> _coordinates{};
 };
 
 using Vec2 = Vector<2>;
@@ -92,7 +145,7 @@ inline auto operator==(const Vector<size>& lhs, const Vector<size>& rhs)
 {
     auto result = true;
     for (std::size_t i{0}; i < size; ++i) {
-        result &= relativelyEqual(lhs.at(i), rhs.at(i));
+        result &= relativelyEqual(lhs[i], rhs[i]);
     }
     return result;
 }
@@ -106,8 +159,12 @@ inline auto operator+(Vector<size> lhs, const Vector<size>& rhs)
 template<std::size_t size>
 inline auto operator+(const Vector<size>& lhs, Point<size> rhs)
 {
-    for(std::size_t i{0}; i < size; ++i) {
-        rhs.at(i) += lhs.at(i);
+    if constexpr (size == 4) {
+        simd::store(rhs.data(), simd::add(simd::load(rhs.data()), simd::load(lhs.data())));
+    } else {
+        for(std::size_t i{0}; i < size; ++i) {
+            rhs[i] += lhs[i];
+        }
     }
     return rhs;
 }
@@ -121,8 +178,12 @@ inline auto operator-(Vector<size> lhs, const Vector<size>& rhs)
 template<std::size_t size>
 inline auto operator-(Vector<size> vec)
 {
-    for(std::size_t i{0}; i < size; ++i) {
-        vec.at(i) = -vec.at(i);
+    if constexpr (size == 4) {
+        simd::store(vec.data(), simd::negate(simd::load(vec.data())));
+    } else {
+        for(std::size_t i{0}; i < size; ++i) {
+            vec[i] = -vec[i];
+        }
     }
     return vec;
 }
@@ -144,18 +205,22 @@ inline auto operator<<(std::ostream& str, const Vector<size>& vec) -> std::ostre
 {
     str << "[";
     for (std::size_t i{0}; i < size-1; ++i) {
-        str << vec.at(i) << ",";
+        str << vec[i] << ",";
     }
-    str << vec.at(size-1) << "]";
+    str << vec[size-1] << "]";
     return str;
 }
 
 template<std::size_t size>
 inline auto magnitude(const Vector<size>& vec)
 {
+    if constexpr (size == 4) {
+        const auto lanes = simd::load(vec.data());
+        return std::sqrt(simd::dot(lanes, lanes));
+    }
     auto sumOfSquares{0.f};
     for (std::size_t i{0}; i < size; ++i) {
-        sumOfSquares += std::pow(vec.at(i), 2.f);
+        sumOfSquares += std::pow(vec[i], 2.f);
     }
     return std::sqrt(sumOfSquares);
 }
@@ -164,8 +229,12 @@ template<std::size_t size>
 inline auto normalize(Vector<size> vec)
 {
     const auto mag = magnitude(vec);
-    for (std::size_t i{0}; i < size; ++i) {
-        vec.at(i) /= mag;
+    if constexpr (size == 4) {
+        simd::store(vec.data(), simd::div(simd::load(vec.data()), simd::broadcast(mag)));
+    } else {
+        for (std::size_t i{0}; i < size; ++i) {
+            vec[i] /= mag;
+        }
     }
     return vec;
 }
@@ -173,9 +242,12 @@ inline auto normalize(Vector<size> vec)
 template<std::size_t size>
 inline auto dotProduct(const Vector<size>& lhs, const Vector<size>& rhs)
 {
+    if constexpr (size == 4) {
+        return simd::dot(simd::load(lhs.data()), simd::load(rhs.data()));
+    }
     auto dotProduct = 0.f;
     for (std::size_t i{0}; i < size; ++i) {
-        dotProduct += lhs.at(i) * rhs.at(i);
+        dotProduct += lhs[i] * rhs[i];
     }
     return dotProduct;
 }
@@ -188,11 +260,11 @@ auto Vector<size>::cross(const Vector<size>& rhs) -> Vector<size>&
         throw std::runtime_error("implementation does not support cross product"
                                  "for vectors with size different than 3");
     }
-    const auto x=this->at(0);
-    const auto y=this->at(1);
-    const auto z=this->at(2);
-    _coordinates[0] = y*rhs.at(2) - z*rhs.at(1);
-    _coordinates[1] = z*rhs.at(0) - x*rhs.at(2);
-    _coordinates[2] = x*rhs.at(1) - y*rhs.at(0);
+    const auto x=_coordinates[0];
+    const auto y=_coordinates[1];
+    const auto z=_coordinates[2];
+    _coordinates[0] = y*rhs[2] - z*rhs[1];
+    _coordinates[1] = z*rhs[0] - x*rhs[2];
+    _coordinates[2] = x*rhs[1] - y*rhs[0];
     return *this;
 }
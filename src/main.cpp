@@ -4,8 +4,24 @@
 #include "Color.hpp"
 #include "Transformations.hpp"
 #include "MathConsts.hpp"
+#include "AllocationTracking.hpp"
+#include "Camera.hpp"
+#include "CostMap.hpp"
+#include "Instrumentation.hpp"
+#include "Renderer.hpp"
+#include "Scene.hpp"
+#include "Sphere.hpp"
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
 
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdlib>
 #include <iostream>
+#include <optional>
+#include <string>
+#include <system_error>
 
 struct Projectile
 {
@@ -50,19 +66,39 @@ auto throwStone(Canvas& canvas) -> void
 
 }
 
+constexpr std::size_t clockCanvasSize{300};
+
+// cos and sin of the 30 degrees between two hours
+constexpr auto hourCosine{0.8660254f};
+constexpr auto hourSine{0.5f};
+
+// the twelve hours on a unit circle around the origin, twelve o'clock first
+constexpr auto hourDirections = []{
+    constexpr auto twelveOClock = Point4{0.f, 1.f, 0.f, 1.f};
+    std::array<Point4, 12> directions{};
+    TransformationStacker rotation;
+    for (auto& direction: directions) {
+        direction = rotation.getMatrix()*twelveOClock;
+        rotation.rotate_z(hourCosine, hourSine);
+    }
+    return directions;
+}();
+
+// the clock face fills 80% of the shorter canvas side
+constexpr auto clockFaceRatio{0.4f};
+
 auto drawClock(Canvas& canvas) -> void
 {
-    const float halfOfCanvHeight = static_cast<float>(canvas.height()/2);
-    const float halfOfCanvWidth = static_cast<float>(canvas.width()/2);
-    auto startPoint = Point4{0.f, halfOfCanvHeight - 30.f, 0.f, 1.f};
-    auto degreeBetweenHours = mathConst::pi/6.f;
     Color color{1.f, 0.f, 0.f};
 
-    for (float hour{0.f}; hour < 12.f; ++hour) {
-        auto rotateOneHour = TransformationStacker().rotate_z(hour*degreeBetweenHours)
-                                                    .translate(halfOfCanvWidth, halfOfCanvHeight, 0.f)
-                                                    .getMatrix();
-        auto hourPos = rotateOneHour*startPoint;
+    const auto centreX = static_cast<float>(canvas.width())/2.f;
+    const auto centreY = static_cast<float>(canvas.height())/2.f;
+    const auto radius = clockFaceRatio*static_cast<float>(std::min(canvas.width(), canvas.height()));
+    const auto placeHour = TransformationStacker().scale(radius, radius, 1.f)
+                                                  .translate(centreX, centreY, 0.f)
+                                                  .getMatrix();
+    for (const auto& direction: hourDirections) {
+        const auto hourPos = placeHour*direction;
         try{
             canvas.setPixel(static_cast<std::size_t>(hourPos.at(0)),
                             canvas.height()-static_cast<std::size_t>(hourPos.at(1)),
@@ -73,14 +109,117 @@ auto drawClock(Canvas& canvas) -> void
     }
 }
 
+// a ring of spheres around a large flattened one
+auto sphereRing() -> Scene
+{
+    const trace::Span span{"scene setup"};
+    Scene scene;
+    auto floor = Sphere();
+    floor.setTransform(TransformationStacker().scale(6.f, 0.1f, 6.f)
+                                              .translate(0.f, -1.f, 0.f)
+                                              .getTransform());
+    scene.add(floor);
+    TransformationStacker ring;
+    for (std::size_t i{0}; i < 12; ++i) {
+        auto sphere = Sphere();
+        sphere.setTransform(TransformationStacker{ring}
+                                .scale(0.4f, 0.4f, 0.4f)
+                                .translate(3.f, -0.5f, 0.f)
+                                .getTransform());
+        scene.add(sphere);
+        ring.rotate_y(mathConst::pi/6.f);
+    }
+    scene.add(Sphere());
+    return scene;
+}
+
+// silhouettes only; with a cost map, which pixels were expensive as well
+auto renderSpheres(ThreadPool& pool, bool costs) -> Canvas
+{
+    auto scene = sphereRing();
+    scene.build();
+
+    Camera camera{640, 360, mathConst::pi/3.f};
+    camera.setTransform(view_transform(Point4{0.f, 3.f, -8.f, 1.f},
+                                      Point4{0.f, 0.f, 0.f, 1.f},
+                                      Vec4{0.f, 1.f, 0.f, 0.f}));
+    Canvas canvas{camera.hsize(), camera.vsize(), Color{0.f, 0.f, 0.f}, CanvasLayout::tiled32};
+    const RenderSettings settings{Color{0.9f, 0.6f, 0.2f}, Color{0.1f, 0.1f, 0.1f}};
+    const Renderer renderer{scene, camera, settings};
+    if (costs) {
+        CostMap costMap{camera.hsize(), camera.vsize()};
+        renderer.renderCosts(canvas, costMap, pool);
+        costMap.saveBeside("./spheres.ppm");
+    } else {
+        renderer.render(canvas, pool);
+    }
+    return canvas;
+}
+
+// usage: ray_tracer [threads] [--trace file] [--costs]
+// Threads default to the hardware concurrency. --trace records the sphere
+// render and its save as a Chrome trace, --costs writes heatmaps of what
+// every pixel of it cost next to spheres.ppm.
+auto usage() -> int
+{
+    std::cerr << "usage: ray_tracer [threads] [--trace file] [--costs]\n";
+    return EXIT_FAILURE;
+}
+
+// the whole argument as a thread count, nothing when it is not a number
+auto parseThreads(const std::string& argument) -> std::optional<std::size_t>
+{
+    std::size_t threads{0};
+    const auto* const end = argument.data() + argument.size();
+    const auto [parsed, error] = std::from_chars(argument.data(), end, threads);
+    if (argument.empty() || error != std::errc{} || parsed != end) {
+        return std::nullopt;
+    }
+    return threads;
+}
+
 #ifdef UNIT_TEST
-int uut_main()
+int uut_main(int argc, char* argv[])
 #else
-int main()
+int main(int argc, char* argv[])
 #endif
 {
-    Canvas canvas{300, 300, Color{0.1f, 0.1f, 0.1f}};
+    auto threads = ThreadPool::defaultThreadCount();
+    std::string tracePath;
+    auto costs = false;
+    for (auto i = 1; i < argc; ++i) {
+        const std::string argument{argv[i]};
+        if (argument == "--trace") {
+            if (i + 1 == argc) {
+                return usage();
+            }
+            tracePath = argv[++i];
+        } else if (argument == "--costs") {
+            costs = true;
+        } else if (const auto count = parseThreads(argument)) {
+            threads = *count;
+        } else {
+            return usage();
+        }
+    }
+
+    Canvas canvas{clockCanvasSize, clockCanvasSize, Color{0.1f, 0.1f, 0.1f}};
     drawClock(canvas);
     canvas.saveToFile("./shot.ppm");
+
+    ThreadPool pool{threads};
+    if (!tracePath.empty()) {
+        trace::start();
+    }
+    renderSpheres(pool, costs).saveToFile("./spheres.ppm", PpmFormat::plain, pool);
+    if (!tracePath.empty()) {
+        trace::stop(tracePath);
+    }
+    if (instrument::enabled()) {
+        std::cerr << instrument::summary(instrument::collect());
+    }
+    if (allocation::tracking()) {
+        std::cerr << allocation::summary(allocation::collect());
+    }
     return 0;
 }
@@ -0,0 +1,113 @@
+#include "Affine.hpp"
+#include "Transformations.hpp"
+#include "MathConsts.hpp"
+#include "Ray.hpp"
+
+#include "gtest/gtest.h"
+
+namespace
+{
+auto expectNear(const Mat4& lhs, const Mat4& rhs) -> void
+{
+    for (std::size_t row{0}; row < 4; ++row) {
+        for (std::size_t column{0}; column < 4; ++column) {
+            EXPECT_NEAR(lhs.at(row, column), rhs.at(row, column), 1e-5f);
+        }
+    }
+}
+}
+
+TEST(affine, default_is_identity)
+{
+    ASSERT_EQ(Affine3{}.toMatrix(), matrix::identity4);
+}
+
+TEST(affine, should_round_trip_through_mat4)
+{
+    const Mat4 m{1.f, 2.f, 3.f, 4.f,
+                 5.f, 6.f, 7.f, 8.f,
+                 9.f, 10.f, 11.f, 12.f,
+                 0.f, 0.f, 0.f, 1.f};
+    ASSERT_EQ(Affine3{m}.toMatrix(), m);
+    ASSERT_THROW(Affine3{}.at(3, 0), std::runtime_error);
+    ASSERT_THROW(Affine3{}.at(0, 4), std::runtime_error);
+}
+
+TEST(affine, composition_should_match_mat4_multiplication)
+{
+    const auto a = translation(1.f, 2.f, 3.f)*rotation_x(0.3f);
+    const auto b = scaling(2.f, 3.f, 4.f)*shearing(1.f, 0.f, 0.5f, 0.f, 0.f, 2.f);
+    expectNear((Affine3{a}*Affine3{b}).toMatrix(), a*b);
+}
+
+TEST(affine, point_and_vector_transform_should_match_mat4)
+{
+    const auto m = translation(1.f, -2.f, 3.f)*scaling(2.f, 3.f, 4.f)*rotation_y(0.7f);
+    const Point4 p{1.f, 2.f, 3.f, 1.f};
+    const Vec4 v{1.f, 2.f, 3.f, 0.f};
+    ASSERT_EQ(Affine3{m}*p, m*p);
+    ASSERT_EQ(Affine3{m}*v, m*v);
+}
+
+TEST(affine, inverse_should_match_mat4_inverse)
+{
+    const auto m = translation(1.f, -2.f, 3.f)*scaling(2.f, 3.f, 4.f)*rotation_z(0.7f);
+    expectNear(inverse(Affine3{m}).toMatrix(), inverse(m));
+}
+
+TEST(affine, rigid_inverse_should_match_general_inverse)
+{
+    const auto m = translation(1.f, -2.f, 3.f)*rotation_x(0.4f)*rotation_z(1.1f);
+    expectNear(rigidInverse(Affine3{m}).toMatrix(), inverse(m));
+}
+
+TEST(affine, stacker_should_match_matrix_products)
+{
+    const auto stacked = TransformationStacker().rotate_x(0.5f)
+                                                .rotate_y(1.5f)
+                                                .rotate_z(-0.7f)
+                                                .scale(2.f, 3.f, 4.f)
+                                                .shear(1.f, 0.f, 0.f, 2.f, 0.f, 0.f)
+                                                .translate(5.f, 6.f, 7.f);
+    const auto expected = translation(5.f, 6.f, 7.f)*
+                          shearing(1.f, 0.f, 0.f, 2.f, 0.f, 0.f)*
+                          scaling(2.f, 3.f, 4.f)*
+                          rotation_z(-0.7f)*
+                          rotation_y(1.5f)*
+                          rotation_x(0.5f);
+    expectNear(stacked.getMatrix(), expected);
+    expectNear(stacked.getTransform().inverse(), inverse(expected));
+}
+
+TEST(affine, rigid_stack_inverse_should_undo_transformation)
+{
+    const auto transform = TransformationStacker().rotate_y(mathConst::pi/3.f)
+                                                  .translate(1.f, 2.f, 3.f)
+                                                  .getTransform();
+    expectNear(transform.matrix()*transform.inverse(), matrix::identity4);
+}
+
+TEST(affine, non_unit_rotation_pair_should_not_be_treated_as_rigid)
+{
+    const auto transform = TransformationStacker().rotate_z(2.f, 0.f)
+                                                  .translate(1.f, 2.f, 3.f)
+                                                  .getTransform();
+    expectNear(transform.matrix()*transform.inverse(), matrix::identity4);
+}
+
+TEST(affine, ray_transform_should_match_mat4)
+{
+    const Ray r{Point4{1.f, 2.f, 3.f, 1.f}, Vec4{0.f, 1.f, 0.f, 0.f}};
+    const auto m = scaling(2.f, 3.f, 4.f)*translation(3.f, 4.f, 5.f);
+    const auto viaAffine = r.transform(Affine3{m});
+    const auto viaMatrix = r.transform(m);
+    ASSERT_EQ(viaAffine.origin(), viaMatrix.origin());
+    ASSERT_EQ(viaAffine.direction(), viaMatrix.direction());
+}
+
+TEST(affine, transform_should_reject_projective_matrix)
+{
+    Mat4 projective{matrix::identity4};
+    projective.at(3, 2) = 1.f;
+    ASSERT_THROW(Transform{projective}, std::runtime_error);
+}
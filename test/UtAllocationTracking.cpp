@@ -0,0 +1,93 @@
+#include "AllocationTracking.hpp"
+#include "Camera.hpp"
+#include "Canvas.hpp"
+#include "Color.hpp"
+#include "Instrumentation.hpp"
+#include "MathConsts.hpp"
+#include "Renderer.hpp"
+#include "Scene.hpp"
+#include "SceneGenerator.hpp"
+#include "Sphere.hpp"
+#include "Transformations.hpp"
+
+#include "gtest/gtest.h"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+TEST(allocationTracking, scope_should_count_the_allocations_of_its_thread)
+{
+    ASSERT_TRUE(allocation::tracking());
+    const allocation::AllocationScope scope;
+    std::vector<double> values(1000);
+    std::thread{[]() { std::vector<double> other(1000); }}.join();
+    auto aligned = std::make_unique<Color[]>(3);
+    aligned.reset();
+    const auto counts = scope.counts();
+    // the thread object itself may allocate, its vector does not count
+    ASSERT_GE(counts.allocations, 2u);
+    ASSERT_GE(counts.bytes, 1000*sizeof(double) + 3*sizeof(Color));
+    ASSERT_LT(counts.bytes, 2000*sizeof(double));
+    ASSERT_GE(counts.deallocations, 1u);
+}
+
+TEST(allocationTracking, collect_should_attribute_allocations_to_phases)
+{
+    // registers the instrumentation record of this thread beforehand
+    { const instrument::ScopedPhase warmUp{instrument::Phase::save}; }
+    allocation::collect();
+    {
+        const instrument::ScopedPhase phase{instrument::Phase::save};
+        std::vector<char> buffer(4096);
+    }
+    std::vector<char> outside(100);
+    const auto report = allocation::collect();
+#ifdef RAY_TRACER_TRACK_ALLOCATIONS
+    ASSERT_EQ(report.phase(instrument::Phase::save).allocations, 1u);
+    ASSERT_EQ(report.phase(instrument::Phase::save).bytes, 4096u);
+#else
+    // phases are only followed with the ALLOCATION_TRACKING option
+    ASSERT_EQ(report.phase(instrument::Phase::save).allocations, 0u);
+#endif
+    ASSERT_GE(report.total().allocations, 2u);
+    ASSERT_GE(report.total().bytes, 4196u);
+    ASSERT_EQ(allocation::collect().total().allocations, 0u);
+    ASSERT_NE(allocation::summary(report).find("outside phases"), std::string::npos);
+}
+
+TEST(allocationTracking, no_allocation_scope_should_abort_on_allocation)
+{
+    ASSERT_DEATH({
+        const allocation::NoAllocationScope scope;
+        std::vector<int> values(16);
+    }, "allocation of 64 bytes");
+}
+
+// the regression gate for the per ray path: camera rays, transforms,
+// intersection with and without a BVH, and writing pixels
+TEST(allocationTracking, rendering_should_not_allocate)
+{
+    const SceneSpec spec{300};
+    auto scene = generateScene(spec);
+    const auto camera = generatedSceneCamera(spec, 48, 27);
+    const Renderer renderer{scene, camera};
+    Canvas canvas{camera.hsize(), camera.vsize()};
+    Canvas tiled{camera.hsize(), camera.vsize(), Color{0.f, 0.f, 0.f}, CanvasLayout::morton, PixelFormat::rgbHalf};
+    {
+        const allocation::NoAllocationScope forbidden;
+        renderer.render(canvas);
+        renderer.renderPackets<8>(tiled);
+    }
+    scene.build();
+    const allocation::AllocationScope scope;
+    renderer.render(canvas);
+    renderer.renderPackets<4>(canvas);
+    renderer.renderPackets<16>(tiled);
+    auto sphere = Sphere();
+    sphere.setTransform(TransformationStacker().scale(2.f, 1.f, 1.f).rotate_y(mathConst::pi/5.f).getTransform());
+    const auto hits = sphere.intersect(camera.rayForPixel(24, 13), 0);
+    ASSERT_EQ(scope.counts().allocations, 0u);
+    ASSERT_EQ(scope.counts().deallocations, 0u);
+    ASSERT_LE(hits.size(), 2u);
+}
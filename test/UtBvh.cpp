@@ -0,0 +1,220 @@
+#include "Bvh.hpp"
+#include "Camera.hpp"
+#include "MathConsts.hpp"
+#include "Scene.hpp"
+#include "Sphere.hpp"
+#include "Transformations.hpp"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+auto sphereAt(float x, float y, float z, float scale) -> Sphere
+{
+    auto sphere = Sphere();
+    sphere.setTransform(TransformationStacker().scale(scale, scale, scale)
+                                               .translate(x, y, z)
+                                               .getTransform());
+    return sphere;
+}
+
+// a few hundred spheres on a jittered grid, some of them overlapping
+auto gridScene() -> Scene
+{
+    Scene scene;
+    for (std::size_t i{0}; i < 300; ++i) {
+        const auto f = static_cast<float>(i);
+        const auto jitter = static_cast<float>((i*7919) % 13)/13.f;
+        scene.add(sphereAt(static_cast<float>(i % 10) - 4.5f + 0.3f*jitter,
+                           static_cast<float>((i/10) % 6) - 2.5f,
+                           static_cast<float>(i/60)*1.5f + jitter,
+                           0.2f + 0.03f*static_cast<float>(i % 5) + 0.001f*f));
+    }
+    return scene;
+}
+
+auto testCamera() -> Camera
+{
+    Camera camera{64, 48, mathConst::pi/2.f};
+    camera.setTransform(view_transform(Point4{0.5f, 1.f, -8.f, 1.f},
+                                      Point4{0.f, 0.f, 3.f, 1.f},
+                                      Vec4{0.f, 1.f, 0.f, 0.f}));
+    return camera;
+}
+
+auto expectSameHits(const Scene& accelerated, const Scene& reference, const Camera& camera) -> std::size_t
+{
+    std::size_t hits{0};
+    for (std::size_t y{0}; y < camera.vsize(); ++y) {
+        for (std::size_t x{0}; x < camera.hsize(); ++x) {
+            const auto ray = camera.rayForPixel(x, y);
+            const auto expected = reference.hit(ray);
+            const auto actual = accelerated.hit(ray);
+            EXPECT_EQ(actual.has_value(), expected.has_value()) << x << "," << y;
+            if (expected && actual) {
+                ++hits;
+                EXPECT_EQ(*actual, *expected) << x << "," << y;
+            }
+        }
+    }
+    return hits;
+}
+
+auto contains(const BoundingBox& outer, const BoundingBox& inner) -> bool
+{
+    for (std::size_t axis{0}; axis < 3; ++axis) {
+        if (inner.min[axis] < outer.min[axis] || inner.max[axis] > outer.max[axis]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+auto expectValidTree(const Bvh& bvh, const std::vector<BoundingBox>& boxes) -> void
+{
+    const auto& nodes = bvh.nodes();
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(nodes.data()) % 64, 0);
+    std::vector<std::uint32_t> seen;
+    for (std::size_t i{0}; i < nodes.size(); ++i) {
+        if (i == 1) {
+            continue;
+        }
+        const auto& node = nodes[i];
+        if (node.leaf()) {
+            ASSERT_LE(node.count, Bvh::maxLeafSize);
+            for (auto p = node.offset; p < node.offset + node.count; ++p) {
+                const auto id = bvh.primitives()[p];
+                seen.push_back(id);
+                ASSERT_TRUE(contains(node.bounds, boxes[id]));
+            }
+        } else {
+            ASSERT_EQ(node.offset % 2, 0);
+            ASSERT_GT(node.offset, i);
+            ASSERT_TRUE(contains(node.bounds, nodes[node.offset].bounds));
+            ASSERT_TRUE(contains(node.bounds, nodes[node.offset + 1].bounds));
+        }
+    }
+    std::sort(seen.begin(), seen.end());
+    ASSERT_EQ(seen.size(), boxes.size());
+    for (std::size_t id{0}; id < seen.size(); ++id) {
+        ASSERT_EQ(seen[id], id);
+    }
+}
+}
+
+TEST(bvh, empty_hierarchy_has_no_hits)
+{
+    const Bvh bvh;
+    ASSERT_TRUE(bvh.empty());
+    const auto ray = Ray{Point4{0.f, 0.f, -5.f, 1.f}, Vec4{0.f, 0.f, 1.f, 0.f}};
+    ASSERT_FALSE(bvh.nearest(ray, [](std::size_t) { return std::optional<float>{1.f}; }));
+}
+
+TEST(bvh, overlapping_primitives_share_root_leaf)
+{
+    const std::vector<BoundingBox> boxes{BoundingBox{{0.f, 0.f, 0.f}, {1.f, 1.f, 1.f}},
+                                         BoundingBox{{0.25f, 0.f, 0.f}, {1.25f, 1.f, 1.f}}};
+    const Bvh bvh{boxes};
+    ASSERT_TRUE(bvh.nodes()[0].leaf());
+    ASSERT_EQ(bvh.nodes()[0].count, 2);
+    ASSERT_EQ(bvh.nodes()[0].bounds, (BoundingBox{{0.f, 0.f, 0.f}, {1.25f, 1.f, 1.f}}));
+}
+
+TEST(bvh, separated_primitives_are_split)
+{
+    const std::vector<BoundingBox> boxes{BoundingBox{{0.f, 0.f, 0.f}, {1.f, 1.f, 1.f}},
+                                         BoundingBox{{5.f, 0.f, 0.f}, {6.f, 1.f, 1.f}}};
+    const Bvh bvh{boxes};
+    ASSERT_FALSE(bvh.nodes()[0].leaf());
+    ASSERT_EQ(bvh.nodes()[2].bounds, boxes[0]);
+    ASSERT_EQ(bvh.nodes()[3].bounds, boxes[1]);
+}
+
+TEST(bvh, tree_covers_every_primitive_once)
+{
+    const auto scene = gridScene();
+    const auto boxes = scene.spheres().bounds();
+    const Bvh bvh{boxes};
+    expectValidTree(bvh, boxes);
+    ASSERT_LT(bvh.depth(), 20);
+}
+
+TEST(bvh, coincident_primitives_stay_within_stack_depth)
+{
+    const std::vector<BoundingBox> boxes(5000, BoundingBox{{0.f, 0.f, 0.f}, {1.f, 1.f, 1.f}});
+    const Bvh bvh{boxes};
+    expectValidTree(bvh, boxes);
+    ASSERT_LT(bvh.depth(), Bvh::stackSize);
+}
+
+TEST(bvh, nearest_should_match_testing_every_sphere)
+{
+    const auto reference = gridScene();
+    auto scene = gridScene();
+    scene.build();
+    ASSERT_TRUE(scene.accelerated());
+    ASSERT_GT(expectSameHits(scene, reference, testCamera()), 0);
+}
+
+TEST(bvh, packets_should_match_single_rays)
+{
+    auto scene = gridScene();
+    scene.build();
+    const auto camera = testCamera();
+    for (std::size_t y{0}; y < camera.vsize(); ++y) {
+        for (std::size_t x{0}; x < camera.hsize(); x += 8) {
+            RayPacket<8> packet;
+            for (std::size_t lane{0}; lane < 8; ++lane) {
+                packet.setRay(lane, camera.rayForPixel(x + lane, y));
+            }
+            PacketHits<8> hits;
+            scene.intersect(packet, hits);
+            for (std::size_t lane{0}; lane < 8; ++lane) {
+                const auto expected = scene.hit(camera.rayForPixel(x + lane, y));
+                ASSERT_EQ(hits.hit(lane), expected.has_value());
+                if (expected) {
+                    ASSERT_EQ(hits.t[lane], expected->t);
+                    ASSERT_EQ(hits.object[lane], expected->object);
+                }
+            }
+        }
+    }
+}
+
+TEST(bvh, refit_follows_moved_spheres)
+{
+    auto scene = gridScene();
+    auto reference = gridScene();
+    scene.build();
+    const auto nodeCount = scene.bvh().nodes().size();
+    for (std::size_t id{0}; id < scene.spheres().size(); id += 3) {
+        const auto moved = TransformationStacker().scale(0.4f, 0.4f, 0.4f)
+                                                  .translate(static_cast<float>(id % 7) - 3.f,
+                                                             1.f - static_cast<float>(id % 4),
+                                                             static_cast<float>(id % 5))
+                                                  .getTransform();
+        scene.setTransform(id, moved);
+        reference.setTransform(id, moved);
+    }
+    ASSERT_FALSE(scene.accelerated());
+    scene.refit();
+    ASSERT_TRUE(scene.accelerated());
+    ASSERT_EQ(scene.bvh().nodes().size(), nodeCount);
+    expectValidTree(scene.bvh(), scene.spheres().bounds());
+    ASSERT_GT(expectSameHits(scene, reference, testCamera()), 0);
+}
+
+TEST(bvh, adding_a_sphere_drops_the_hierarchy)
+{
+    auto scene = gridScene();
+    scene.build();
+    scene.add(sphereAt(0.f, 0.f, -6.f, 0.5f));
+    ASSERT_FALSE(scene.accelerated());
+    const auto hit = scene.hit(Ray{Point4{0.f, 0.f, -8.f, 1.f}, Vec4{0.f, 0.f, 1.f, 0.f}});
+    ASSERT_TRUE(hit);
+    ASSERT_EQ(hit->object, 300);
+}
@@ -0,0 +1,67 @@
+#include "Camera.hpp"
+#include "MathConsts.hpp"
+#include "Transformations.hpp"
+
+#include "gtest/gtest.h"
+#include <cmath>
+
+namespace
+{
+auto expectRayNear(const Ray& ray, const Point4& origin, const Vec4& direction) -> void
+{
+    for (std::size_t i{0}; i < 4; ++i) {
+        EXPECT_NEAR(ray.origin()[i], origin[i], 1e-5f);
+        EXPECT_NEAR(ray.direction()[i], direction[i], 1e-5f);
+    }
+}
+}
+
+TEST(camera, pixel_size_for_horizontal_canvas)
+{
+    const Camera camera{200, 125, mathConst::pi/2.f};
+    ASSERT_NEAR(camera.pixelSize(), 0.01f, 1e-6f);
+}
+
+TEST(camera, pixel_size_for_vertical_canvas)
+{
+    const Camera camera{125, 200, mathConst::pi/2.f};
+    ASSERT_NEAR(camera.pixelSize(), 0.01f, 1e-6f);
+}
+
+TEST(camera, ray_through_center_of_canvas)
+{
+    const Camera camera{201, 101, mathConst::pi/2.f};
+    expectRayNear(camera.rayForPixel(100, 50),
+                  Point4{0.f, 0.f, 0.f, 1.f},
+                  Vec4{0.f, 0.f, -1.f, 0.f});
+}
+
+TEST(camera, ray_through_corner_of_canvas)
+{
+    const Camera camera{201, 101, mathConst::pi/2.f};
+    expectRayNear(camera.rayForPixel(0, 0),
+                  Point4{0.f, 0.f, 0.f, 1.f},
+                  Vec4{0.66519f, 0.33259f, -0.66851f, 0.f});
+}
+
+TEST(camera, ray_through_a_point_within_a_pixel)
+{
+    const Camera camera{201, 101, mathConst::pi/2.f};
+    expectRayNear(camera.rayForPixel(0, 0, 0.f, 0.f),
+                  Point4{0.f, 0.f, 0.f, 1.f},
+                  Vec4{0.66630f, 0.33481f, -0.66630f, 0.f});
+    expectRayNear(camera.rayForPixel(100, 50, 0.5f, 0.5f),
+                  Point4{0.f, 0.f, 0.f, 1.f},
+                  Vec4{0.f, 0.f, -1.f, 0.f});
+}
+
+TEST(camera, ray_when_camera_is_transformed)
+{
+    Camera camera{201, 101, mathConst::pi/2.f};
+    camera.setTransform(TransformationStacker().translate(0.f, -2.f, 5.f)
+                                               .rotate_y(mathConst::pi/4.f)
+                                               .getTransform());
+    expectRayNear(camera.rayForPixel(100, 50),
+                  Point4{0.f, 2.f, -5.f, 1.f},
+                  Vec4{std::sqrt(2.f)/2.f, 0.f, -std::sqrt(2.f)/2.f, 0.f});
+}
@@ -0,0 +1,139 @@
+#include "CostMap.hpp"
+#include "Camera.hpp"
+#include "Canvas.hpp"
+#include "Color.hpp"
+#include "MathConsts.hpp"
+#include "Renderer.hpp"
+#include "Scene.hpp"
+#include "Sphere.hpp"
+#include "ThreadPool.hpp"
+#include "Transformations.hpp"
+
+#include "gtest/gtest.h"
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+namespace
+{
+auto twoSpheres() -> Scene
+{
+    Scene scene;
+    scene.add(Sphere());
+    auto small = Sphere();
+    small.setTransform(TransformationStacker().scale(0.5f, 0.5f, 0.5f).translate(1.5f, 0.5f, -0.5f).getTransform());
+    scene.add(small);
+    return scene;
+}
+
+auto frontCamera() -> Camera
+{
+    Camera camera{40, 24, mathConst::pi/3.f};
+    camera.setTransform(view_transform(Point4{0.f, 1.f, -6.f, 1.f},
+                                      Point4{0.f, 0.f, 0.f, 1.f},
+                                      Vec4{0.f, 1.f, 0.f, 0.f}));
+    return camera;
+}
+}
+
+TEST(costMap, should_save_and_load_the_raw_counts)
+{
+    CostMap costs{3, 2};
+    costs.set(0, 0, PixelCost{1, 2, 3});
+    costs.set(2, 1, PixelCost{4000000000u, 5, 1ull << 40});
+    const auto filePath = std::filesystem::temp_directory_path()/"ray_tracer_costs.costs";
+    costs.save(filePath);
+    ASSERT_EQ(std::filesystem::file_size(filePath), 24u + 6u*16u);
+    const auto loaded = CostMap::load(filePath);
+    ASSERT_EQ(loaded.width(), 3u);
+    ASSERT_EQ(loaded.height(), 2u);
+    ASSERT_EQ(loaded.value(0, 0, CostMetric::bvhNodes), 2u);
+    ASSERT_EQ(loaded.value(2, 1, CostMetric::sphereTests), 4000000000u);
+    ASSERT_EQ(loaded.value(2, 1, CostMetric::cycles), 1ull << 40);
+    ASSERT_EQ(loaded.value(1, 1, CostMetric::cycles), 0u);
+
+    std::ofstream{filePath} << "RTCOSTS";
+    ASSERT_THROW(CostMap::load(filePath), std::runtime_error);
+    std::filesystem::remove(filePath);
+}
+
+TEST(costMap, heatmap_should_run_from_black_to_white)
+{
+    CostMap costs{200, 1};
+    for (std::size_t x{0}; x < 200; ++x) {
+        costs.set(x, 0, PixelCost{static_cast<std::uint32_t>(x), 0, 0});
+    }
+    // an outlier does not move the top of the scale
+    costs.set(199, 0, PixelCost{1000000, 0, 0});
+    const auto heatmap = costs.heatmap(CostMetric::sphereTests);
+    ASSERT_EQ(heatmap(0, 0), Color(0.f, 0.f, 0.f));
+    ASSERT_EQ(heatmap(197, 0), Color(1.f, 1.f, 1.f));
+    ASSERT_EQ(heatmap(199, 0), Color(1.f, 1.f, 1.f));
+    const Color middle = heatmap(99, 0);
+    ASSERT_GT(middle.r(), middle.b());
+
+    const auto empty = costs.heatmap(CostMetric::bvhNodes);
+    for (const auto& pixel: empty) {
+        ASSERT_EQ(pixel.color, Color(0.f, 0.f, 0.f));
+    }
+}
+
+TEST(costMap, render_costs_should_count_the_work_of_every_pixel)
+{
+    auto scene = twoSpheres();
+    const auto camera = frontCamera();
+    const Renderer renderer{scene, camera};
+    Canvas expected{camera.hsize(), camera.vsize()};
+    renderer.render(expected);
+
+    Canvas canvas{camera.hsize(), camera.vsize()};
+    CostMap costs{camera.hsize(), camera.vsize()};
+    renderer.renderCosts(canvas, costs);
+    std::uint64_t cycles{0};
+    for (std::size_t y{0}; y < canvas.height(); ++y) {
+        for (std::size_t x{0}; x < canvas.width(); ++x) {
+            ASSERT_EQ(canvas.getPixel(x, y), expected.getPixel(x, y));
+            // without a BVH every ray tests every sphere
+            ASSERT_EQ(costs.cost(x, y).sphereTests, 2u);
+            ASSERT_EQ(costs.cost(x, y).bvhNodes, 0u);
+            cycles += costs.cost(x, y).cycles;
+        }
+    }
+    ASSERT_GT(cycles, 0u);
+
+    scene.build();
+    ThreadPool pool{3};
+    CostMap tiled{camera.hsize(), camera.vsize()};
+    renderer.renderCosts(canvas, tiled, pool);
+    std::size_t skipped{0};
+    for (std::size_t y{0}; y < canvas.height(); ++y) {
+        for (std::size_t x{0}; x < canvas.width(); ++x) {
+            ASSERT_EQ(canvas.getPixel(x, y), expected.getPixel(x, y));
+            ASSERT_LE(tiled.cost(x, y).sphereTests, 2u);
+            skipped += tiled.cost(x, y).sphereTests < 2u ? 1u : 0u;
+            if (tiled.cost(x, y).sphereTests > 0) {
+                ASSERT_GT(tiled.cost(x, y).bvhNodes, 0u);
+            }
+        }
+    }
+    ASSERT_GT(skipped, 0u);
+
+    CostMap small{camera.hsize() - 1, camera.vsize()};
+    ASSERT_THROW(renderer.renderCosts(canvas, small), std::runtime_error);
+}
+
+TEST(costMap, should_save_heatmaps_beside_an_image)
+{
+    CostMap costs{4, 4};
+    costs.set(1, 1, PixelCost{3, 2, 1});
+    const auto directory = std::filesystem::temp_directory_path();
+    costs.saveBeside(directory/"ray_tracer_beauty.ppm");
+    for (const auto* name: {"ray_tracer_beauty_sphere_tests.ppm",
+                            "ray_tracer_beauty_bvh_nodes.ppm",
+                            "ray_tracer_beauty_cycles.ppm",
+                            "ray_tracer_beauty.costs"}) {
+        ASSERT_TRUE(std::filesystem::exists(directory/name)) << name;
+        std::filesystem::remove(directory/name);
+    }
+}
@@ -0,0 +1,103 @@
+#include "Instrumentation.hpp"
+#include "Camera.hpp"
+#include "Canvas.hpp"
+#include "MathConsts.hpp"
+#include "Renderer.hpp"
+#include "Scene.hpp"
+#include "Sphere.hpp"
+#include "ThreadPool.hpp"
+#include "Transformations.hpp"
+
+#include "gtest/gtest.h"
+
+#include <string>
+
+TEST(instrumentation, summary_and_json_should_report_every_value)
+{
+    instrument::Report report;
+    report.counts = {1000, 250, 4000, 9000};
+    report.nanoseconds = {2000000000, 100000000, 300000000, 100000000, 500000000, 250000000};
+    ASSERT_DOUBLE_EQ(report.hitRate(), 0.25);
+    ASSERT_DOUBLE_EQ(report.seconds(instrument::Phase::save), 0.25);
+
+    const auto summary = instrument::summary(report);
+    ASSERT_NE(summary.find("intersection         0.300000 s   60.0%"), std::string::npos) << summary;
+    ASSERT_NE(summary.find("hits                        250   25.0%"), std::string::npos) << summary;
+    ASSERT_NE(summary.find("sphere tests               4000     4.00 per ray"), std::string::npos) << summary;
+    ASSERT_NE(summary.find("rays/s                      500"), std::string::npos) << summary;
+
+    const std::string json{"{\"seconds\": {\"render\": 2.000000000, \"ray_generation\": 0.100000000, "
+                           "\"intersection\": 0.300000000, \"shading\": 0.100000000, \"bvh_build\": 0.500000000, "
+                           "\"save\": 0.250000000}, \"counts\": {\"rays\": 1000, \"hits\": 250, "
+                           "\"sphere_tests\": 4000, \"bvh_nodes\": 9000}, \"hit_rate\": 0.250000"};
+    ASSERT_EQ(instrument::toJson(report), json + (instrument::hardwareCounters() ? ", \"hardware\": null}" : "}"));
+}
+
+TEST(instrumentation, summary_and_json_should_report_hardware_events)
+{
+    instrument::Report report;
+    report.measured = {true, true, false, true};
+    report.events[static_cast<std::size_t>(instrument::Phase::intersection)] = {4000, 10000, 0, 25};
+    ASSERT_DOUBLE_EQ(report.instructionsPerCycle(instrument::Phase::intersection), 2.5);
+    ASSERT_DOUBLE_EQ(report.instructionsPerCycle(instrument::Phase::save), 0.0);
+    const auto summary = instrument::summary(report);
+    const auto json = instrument::toJson(report);
+    if (!instrument::hardwareCounters()) {
+        ASSERT_EQ(summary.find("cycles"), std::string::npos) << summary;
+        ASSERT_EQ(json.find("hardware"), std::string::npos) << json;
+        return;
+    }
+    ASSERT_NE(summary.find("intersection               4000          10000   2.50              -             25"),
+              std::string::npos) << summary;
+    ASSERT_NE(json.find("\"intersection\": {\"cycles\": 4000, \"instructions\": 10000, "
+                        "\"cache_misses\": null, \"branch_misses\": 25}"), std::string::npos) << json;
+}
+
+TEST(instrumentation, should_count_the_rays_of_every_render_thread)
+{
+    Scene scene;
+    scene.add(Sphere());
+    auto small = Sphere();
+    small.setTransform(TransformationStacker().scale(0.5f, 0.5f, 0.5f).translate(1.5f, 0.5f, -0.5f).getTransform());
+    scene.add(small);
+    Camera camera{41, 19, mathConst::pi/3.f};
+    camera.setTransform(view_transform(Point4{0.f, 1.f, -6.f, 1.f},
+                                      Point4{0.f, 0.f, 0.f, 1.f},
+                                      Vec4{0.f, 1.f, 0.f, 0.f}));
+    RenderSettings settings;
+    settings.tileSize = 8;
+    const Renderer renderer{scene, camera, settings};
+    ThreadPool pool{3};
+    Canvas canvas{camera.hsize(), camera.vsize()};
+    instrument::collect();
+
+    renderer.render(canvas, pool);
+    auto report = instrument::collect();
+    if (!instrument::enabled()) {
+        ASSERT_EQ(report.count(instrument::Counter::rays), 0u);
+        ASSERT_EQ(report.seconds(instrument::Phase::render), 0.0);
+        return;
+    }
+    std::size_t hits{0};
+    for (const auto& pixel: canvas) {
+        hits += pixel.color == settings.hitColor ? 1u : 0u;
+    }
+    const auto pixels = canvas.width()*canvas.height();
+    ASSERT_EQ(report.count(instrument::Counter::rays), pixels);
+    ASSERT_EQ(report.count(instrument::Counter::hits), hits);
+    // without a BVH every ray is tested against both spheres
+    ASSERT_EQ(report.count(instrument::Counter::sphereTests), 2*pixels);
+    ASSERT_GT(report.seconds(instrument::Phase::render), 0.0);
+    ASSERT_GT(report.seconds(instrument::Phase::intersection), 0.0);
+    ASSERT_EQ(instrument::collect().count(instrument::Counter::rays), 0u);
+
+    scene.build();
+    renderer.renderPackets<8>(canvas, pool);
+    report = instrument::collect();
+    ASSERT_EQ(report.count(instrument::Counter::rays), pixels);
+    ASSERT_EQ(report.count(instrument::Counter::hits), hits);
+    ASSERT_GT(report.count(instrument::Counter::bvhNodes), 0u);
+    if (report.measured[static_cast<std::size_t>(HardwareEvent::instructions)]) {
+        ASSERT_GT(report.event(instrument::Phase::intersection, HardwareEvent::instructions), 0u);
+    }
+}
@@ -0,0 +1,99 @@
+#include "Intersection.hpp"
+#include "AllocationTracking.hpp"
+#include "Canvas.hpp"
+#include "Color.hpp"
+#include "Ray.hpp"
+#include "Sphere.hpp"
+#include "Transformations.hpp"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+TEST(intersections, hit_when_all_intersections_are_positive)
+{
+    Intersections xs;
+    xs.add(Intersection{2.f, 0});
+    xs.add(Intersection{1.f, 0});
+    ASSERT_EQ(xs.hit(), (Intersection{1.f, 0}));
+}
+
+TEST(intersections, hit_when_some_intersections_are_negative)
+{
+    Intersections xs;
+    xs.add(Intersection{-1.f, 0});
+    xs.add(Intersection{1.f, 1});
+    ASSERT_EQ(xs.hit(), (Intersection{1.f, 1}));
+}
+
+TEST(intersections, no_hit_when_all_intersections_are_negative)
+{
+    Intersections xs;
+    xs.add(Intersection{-2.f, 0});
+    xs.add(Intersection{-1.f, 0});
+    ASSERT_FALSE(xs.hit());
+}
+
+TEST(intersections, hit_is_lowest_non_negative_intersection)
+{
+    Intersections xs;
+    xs.add(Intersection{5.f, 0});
+    xs.add(Intersection{7.f, 1});
+    xs.add(Intersection{-3.f, 2});
+    xs.add(Intersection{2.f, 3});
+    ASSERT_EQ(xs.hit(), (Intersection{2.f, 3}));
+}
+
+TEST(intersections, should_keep_records_beyond_inline_capacity)
+{
+    Intersections xs;
+    const auto count = Intersections::inlineCapacity + 5;
+    for (std::size_t i{0}; i < count; ++i) {
+        xs.add(Intersection{static_cast<float>(count - i), i});
+    }
+    ASSERT_EQ(xs.size(), count);
+    ASSERT_EQ(xs[count-1], (Intersection{1.f, count-1}));
+    ASSERT_EQ(xs.hit(), (Intersection{1.f, count-1}));
+    xs.clear();
+    ASSERT_TRUE(xs.empty());
+    ASSERT_FALSE(xs.hit());
+}
+
+TEST(intersections, rendering_a_frame_should_not_allocate_in_intersection_path)
+{
+    std::vector<Sphere> spheres(3);
+    spheres[0].setTransform(scaling(0.5f, 0.5f, 0.5f));
+    spheres[1].setTransform(translation(1.f, 1.f, 0.f));
+    spheres[2].setTransform(TransformationStacker().scale(0.3f, 1.f, 0.3f)
+                                                   .translate(-1.f, 0.f, 1.f)
+                                                   .getTransform());
+    constexpr std::size_t canvasPixels{64};
+    constexpr auto wallSize{7.f};
+    constexpr auto pixelSize = wallSize/static_cast<float>(canvasPixels);
+    Canvas canvas{canvasPixels, canvasPixels};
+    const Point4 rayOrigin{0.f, 0.f, -5.f, 1.f};
+    const Color color{1.f, 0.f, 0.f};
+    Intersections xs;
+    std::size_t hits{0};
+
+    const allocation::AllocationScope scope;
+    for (std::size_t y{0}; y < canvasPixels; ++y) {
+        const auto worldY = wallSize/2.f - pixelSize*static_cast<float>(y);
+        for (std::size_t x{0}; x < canvasPixels; ++x) {
+            const auto worldX = -wallSize/2.f + pixelSize*static_cast<float>(x);
+            const Point4 target{worldX, worldY, 10.f, 1.f};
+            const Ray ray{rayOrigin, normalize(target - rayOrigin)};
+            xs.clear();
+            for (std::size_t id{0}; id < spheres.size(); ++id) {
+                xs.add(spheres[id].intersect(ray, id));
+            }
+            if (xs.hit()) {
+                canvas(x, y) = color;
+                ++hits;
+            }
+        }
+    }
+    ASSERT_TRUE(allocation::tracking());
+    ASSERT_EQ(scope.counts().allocations, 0u);
+    ASSERT_GT(hits, 0);
+}
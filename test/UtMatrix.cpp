@@ -246,3 +246,91 @@ TEST(matrix, should_support_inverse_operation)
 //    m2.inverse();
 //    ASSERT_EQ(multi*m2, m1);
 }
+
+TEST(matrix, closed_form_inverse_should_match_cofactor_expansion)
+{
+    Mat4 m{8.f, -5.f, 9.f, 2.f,
+           7.f, 5.f, 6.f, 1.f,
+           -6.f, 0.f, 9.f, 6.f,
+           -3.f, 0.f, -9.f, -4.f};
+    Mat4 matOfCofactors;
+    for (std::size_t row{0}; row < 4; ++row) {
+        for (std::size_t column{0}; column < 4; ++column) {
+            matOfCofactors.at(column, row) = cofactor(m, row, column)/determinant(m);
+        }
+    }
+    const auto inv = inverse(m);
+    for (std::size_t row{0}; row < 4; ++row) {
+        for (std::size_t column{0}; column < 4; ++column) {
+            ASSERT_NEAR(inv.at(row, column), matOfCofactors.at(row, column), 1e-5f);
+        }
+    }
+}
+
+TEST(matrix, product_multiplied_by_inverse_should_give_original)
+{
+    Mat4 m1{3.f, -9.f, 7.f, 3.f,
+            3.f, -8.f, 2.f, -9.f,
+            -4.f, 4.f, 4.f, 1.f,
+            -6.f, 5.f, -1.f, 1.f};
+    Mat4 m2{8.f, 2.f, 2.f, 2.f,
+            3.f, -1.f, 7.f, 0.f,
+            7.f, 0.f, 5.f, 4.f,
+            6.f, -2.f, 0.f, 5.f};
+    const auto result = m1*m2*inverse(m2);
+    for (std::size_t row{0}; row < 4; ++row) {
+        for (std::size_t column{0}; column < 4; ++column) {
+            ASSERT_NEAR(result.at(row, column), m1.at(row, column), 1e-4f);
+        }
+    }
+}
+
+TEST(matrix, affine_inverse_should_match_general_inverse)
+{
+    Mat4 m{2.f, 1.f, 0.f, 4.f,
+           0.f, 3.f, 1.f, -2.f,
+           1.f, 0.f, 1.f, 7.f,
+           0.f, 0.f, 0.f, 1.f};
+    ASSERT_TRUE(isAffine(m));
+    ASSERT_FALSE(isAffine(Mat4{}));
+    const auto product = m*affineInverse(m);
+    for (std::size_t row{0}; row < 4; ++row) {
+        for (std::size_t column{0}; column < 4; ++column) {
+            ASSERT_NEAR(product.at(row, column), matrix::identity4.at(row, column), 1e-5f);
+        }
+    }
+}
+
+TEST(matrix, unchecked_access_should_match_checked_access)
+{
+    Mat3 m{1.f, 2.f, 3.f,
+           4.f, 5.f, 6.f,
+           7.f, 8.f, 9.f};
+    ASSERT_EQ(m(1, 2), m.at(1, 2));
+    ASSERT_EQ((m.get<2, 0>()), 7.f);
+    ASSERT_EQ(m.data()[4], 5.f);
+    m(0, 1) = 10.f;
+    ASSERT_EQ(m.at(0, 1), 10.f);
+}
+
+TEST(matrix, algebra_should_be_usable_in_constant_expressions)
+{
+    constexpr Mat3 m{1.f, 2.f, 6.f,
+                     -5.f, 8.f, -4.f,
+                     2.f, 6.f, 4.f};
+    static_assert(determinant(m) == -196.f);
+    static_assert(transpose(m).get<0, 1>() == -5.f);
+    static_assert((m*matrix::identity3).get<2, 1>() == 6.f);
+    constexpr Mat4 m4{-2.f, -8.f, 3.f, 5.f,
+                      -3.f, 1.f, 7.f, 3.f,
+                      1.f, 2.f, -9.f, 6.f,
+                      -6.f, 7.f, 7.f, -9.f};
+    static_assert(determinant(m4) == -4071.f);
+    static_assert(isInvertible(m4));
+    constexpr auto product = m4*inverse(m4);
+    for (std::size_t row{0}; row < 4; ++row) {
+        for (std::size_t column{0}; column < 4; ++column) {
+            ASSERT_NEAR(product.at(row, column), matrix::identity4.at(row, column), 1e-5f);
+        }
+    }
+}
@@ -0,0 +1,28 @@
+#include "PerfEvents.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+
+TEST(perfEvents, group_should_count_or_say_why_not)
+{
+    const PerfEventGroup group;
+    if (!group.available()) {
+        // no PMU, e.g. in a container or VM: everything reads as 0
+        ASSERT_NE(group.error(), 0);
+        ASSERT_EQ(group.read(), EventCounts{});
+        return;
+    }
+    const auto before = group.read();
+    volatile std::uint64_t sum{0};
+    for (std::uint64_t i{0}; i < 1000000; ++i) {
+        sum = sum + i;
+    }
+    const auto after = group.read();
+    for (std::size_t i{0}; i < hardwareEventCount; ++i) {
+        ASSERT_GE(after[i], before[i]);
+    }
+    if (group.available(HardwareEvent::instructions)) {
+        ASSERT_GT(after[1] - before[1], 1000000u);
+    }
+}
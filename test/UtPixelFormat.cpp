@@ -0,0 +1,57 @@
+#include "PixelFormat.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+TEST(pixel_format, bytes_per_pixel)
+{
+    ASSERT_EQ(bytesPerPixel(PixelFormat::rgbFloat), 16);
+    ASSERT_EQ(bytesPerPixel(PixelFormat::planarFloat), 12);
+    ASSERT_EQ(bytesPerPixel(PixelFormat::rgbHalf), 6);
+    ASSERT_EQ(bytesPerPixel(PixelFormat::srgb8), 3);
+}
+
+TEST(pixel_format, every_half_should_survive_a_round_trip_through_float)
+{
+    for (std::uint32_t bits{0}; bits <= 0xffff; ++bits) {
+        const auto half = static_cast<std::uint16_t>(bits);
+        const auto value = fromHalf(half);
+        if (std::isnan(value)) {
+            ASSERT_TRUE(std::isnan(fromHalf(toHalf(value))));
+        } else {
+            ASSERT_EQ(toHalf(value), half) << bits;
+        }
+    }
+}
+
+TEST(pixel_format, half_should_round_to_nearest_even)
+{
+    ASSERT_EQ(toHalf(1.f), 0x3c00);
+    ASSERT_EQ(toHalf(-2.f), 0xc000);
+    ASSERT_EQ(toHalf(65504.f), 0x7bff);
+    ASSERT_EQ(toHalf(65519.f), 0x7bff);
+    ASSERT_EQ(toHalf(65520.f), 0x7c00);
+    ASSERT_EQ(toHalf(std::numeric_limits<float>::infinity()), 0x7c00);
+    // halfway between 1 and the next half goes to the even 1
+    ASSERT_EQ(toHalf(1.f + 1.f/2048.f), 0x3c00);
+    ASSERT_EQ(toHalf(1.f + 3.f/2048.f), 0x3c02);
+    // smallest subnormal, and ties below it
+    ASSERT_EQ(toHalf(std::ldexp(1.f, -24)), 0x0001);
+    ASSERT_EQ(toHalf(std::ldexp(1.f, -25)), 0x0000);
+    ASSERT_EQ(toHalf(std::ldexp(3.f, -26)), 0x0001);
+    ASSERT_EQ(toHalf(std::ldexp(1.f, -30)), 0x0000);
+}
+
+TEST(pixel_format, srgb_codes_should_survive_a_round_trip)
+{
+    for (std::uint32_t code{0}; code < 256; ++code) {
+        ASSERT_EQ(encodeSrgb8(decodeSrgb8(static_cast<std::uint8_t>(code))), code);
+    }
+    ASSERT_EQ(encodeSrgb8(0.5f), 188);
+    ASSERT_EQ(encodeSrgb8(-1.f), 0);
+    ASSERT_EQ(encodeSrgb8(2.f), 255);
+    ASSERT_EQ(encodeSrgb8(std::numeric_limits<float>::quiet_NaN()), 0);
+}
@@ -0,0 +1,69 @@
+#include "PlaneFile.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+constexpr planefile::Magic testMagic{'R', 'T', 'P', 'L', 'A', 'N', 'E', 'S'};
+
+struct Pixel
+{
+    std::uint16_t count;
+    double value;
+};
+}
+
+TEST(planeFile, should_read_planes_in_the_order_written)
+{
+    const auto filePath = std::filesystem::temp_directory_path()/"ray_tracer_planes.bin";
+    const std::vector<Pixel> pixels{{1, 0.5}, {2, -1.0}, {65535, 1e300}};
+    planefile::Writer writer{testMagic, 3, 1, sizeof(std::uint16_t) + sizeof(double)};
+    writer.plane<std::uint16_t>(pixels, [](const auto& pixel) { return pixel.count; });
+    writer.plane<double>(pixels, [](const auto& pixel) { return pixel.value; });
+    writer.save(filePath, "test file");
+    ASSERT_EQ(std::filesystem::file_size(filePath), 24u + 3u*10u);
+
+    planefile::Reader reader{filePath, testMagic, sizeof(std::uint16_t) + sizeof(double), "test file"};
+    ASSERT_EQ(reader.width(), 3u);
+    ASSERT_EQ(reader.height(), 1u);
+    std::vector<Pixel> loaded(3);
+    reader.plane<std::uint16_t>(loaded, [](auto& pixel, auto count) { pixel.count = count; });
+    reader.plane<double>(loaded, [](auto& pixel, auto value) { pixel.value = value; });
+    for (std::size_t i{0}; i < pixels.size(); ++i) {
+        ASSERT_EQ(loaded[i].count, pixels[i].count);
+        ASSERT_EQ(loaded[i].value, pixels[i].value);
+    }
+    ASSERT_THROW((planefile::Reader{filePath, testMagic, 9, "test file"}), std::runtime_error);
+    auto otherMagic = testMagic;
+    otherMagic[7] = 'X';
+    ASSERT_THROW((planefile::Reader{filePath, otherMagic, 10, "test file"}), std::runtime_error);
+    std::filesystem::remove(filePath);
+}
+
+TEST(planeFile, should_reject_sizes_that_wrap_around)
+{
+    const auto filePath = std::filesystem::temp_directory_path()/"ray_tracer_planes_wrap.bin";
+    const std::vector<std::uint64_t> values(4);
+    for (const auto& [width, height]: {std::pair<std::uint64_t, std::uint64_t>{(std::uint64_t{1} << 61) + 4, 1},
+                                       {std::uint64_t{1} << 32, (std::uint64_t{1} << 32) + 4}}) {
+        planefile::Writer writer{testMagic, 4, 1, sizeof(std::uint64_t)};
+        writer.plane<std::uint64_t>(values, [](auto value) { return value; });
+        writer.save(filePath, "test file");
+        {
+            // a header whose pixel bytes, 8 per pixel, wrap around to those of 4
+            std::fstream file{filePath, std::ios::binary | std::ios::in | std::ios::out};
+            file.seekp(8);
+            file.write(reinterpret_cast<const char*>(&width), sizeof(width));
+            file.write(reinterpret_cast<const char*>(&height), sizeof(height));
+        }
+        ASSERT_THROW((planefile::Reader{filePath, testMagic, sizeof(std::uint64_t), "test file"}),
+                     std::runtime_error) << width << "x" << height;
+    }
+    std::filesystem::remove(filePath);
+}
@@ -51,3 +51,13 @@ TEST(Point, subtraction_of_a_vector_from_a_point_should_produce_a_point)
     const auto result = p1-v1;
     ASSERT_EQ(result, expected_result);
 }
+
+TEST(Point, unchecked_access_should_match_checked_access)
+{
+    Point3 p{1.f, 2.f, 3.f};
+    ASSERT_EQ(p[2], p.at(2));
+    ASSERT_EQ(p.get<0>(), 1.f);
+    p[1] = 7.f;
+    ASSERT_EQ(p.at(1), 7.f);
+    ASSERT_THROW(p.at(3), std::runtime_error);
+}
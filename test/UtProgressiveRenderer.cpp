@@ -0,0 +1,114 @@
+#include "ProgressiveRenderer.hpp"
+#include "Camera.hpp"
+#include "Canvas.hpp"
+#include "Color.hpp"
+#include "MathConsts.hpp"
+#include "Renderer.hpp"
+#include "Scene.hpp"
+#include "Sphere.hpp"
+#include "ThreadPool.hpp"
+#include "Transformations.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+auto testScene() -> Scene
+{
+    Scene scene;
+    scene.add(Sphere());
+    auto small = Sphere();
+    small.setTransform(TransformationStacker().scale(0.5f, 0.5f, 0.5f)
+                                              .translate(1.5f, 0.5f, -0.5f)
+                                              .getTransform());
+    scene.add(small);
+    scene.build();
+    return scene;
+}
+
+auto testCamera() -> Camera
+{
+    Camera camera{29, 17, mathConst::pi/3.f};
+    camera.setTransform(view_transform(Point4{0.f, 1.f, -6.f, 1.f},
+                                      Point4{0.f, 0.f, 0.f, 1.f},
+                                      Vec4{0.f, 1.f, 0.f, 0.f}));
+    return camera;
+}
+
+auto sameBits(const Canvas& lhs, const Canvas& rhs) -> bool
+{
+    return std::memcmp(lhs.data(), rhs.data(), lhs.storageSize()*sizeof(Color)) == 0;
+}
+}
+
+TEST(progressiveRenderer, passes_should_double_up_to_the_pass_limit)
+{
+    const auto scene = testScene();
+    const auto camera = testCamera();
+    const Renderer renderer{scene, camera};
+    ProgressiveSettings settings;
+    settings.samplesPerPixel = 30;
+    settings.maxPassSamples = 8;
+    const ProgressiveRenderer progressive{renderer, settings};
+    std::vector<std::uint32_t> passes;
+    for (std::uint32_t samples{0}; samples < settings.samplesPerPixel;) {
+        samples = progressive.nextPass(samples);
+        passes.push_back(samples);
+    }
+    ASSERT_EQ(passes, (std::vector<std::uint32_t>{1, 2, 4, 8, 16, 24, 30}));
+}
+
+TEST(progressiveRenderer, resumed_render_should_match_an_uninterrupted_one)
+{
+    const auto scene = testScene();
+    const auto camera = testCamera();
+    RenderSettings renderSettings;
+    renderSettings.tileSize = 8;
+    const Renderer renderer{scene, camera, renderSettings};
+    ThreadPool pool{3};
+
+    ProgressiveSettings settings;
+    settings.samplesPerPixel = 12;
+    settings.maxPassSamples = 4;
+    Canvas expected{camera.hsize(), camera.vsize()};
+    std::size_t passes{0};
+    ASSERT_TRUE(ProgressiveRenderer(renderer, settings).render(expected, pool, [&](const SampleBuffer&) {
+        ++passes;
+        return true;
+    }));
+    ASSERT_EQ(passes, 5u);
+
+    // preempted after every pass, with a new renderer and pool each time
+    settings.checkpoint = "./test_progressive.checkpoint";
+    std::filesystem::remove(settings.checkpoint);
+    Canvas canvas{camera.hsize(), camera.vsize()};
+    std::size_t runs{0};
+    for (auto finished = false; !finished; ++runs) {
+        ThreadPool otherPool{1 + runs % 2};
+        finished = ProgressiveRenderer(renderer, settings).render(canvas, otherPool, [](const SampleBuffer&) {
+            return false;
+        });
+        ASSERT_EQ(std::filesystem::exists(settings.checkpoint), !finished);
+    }
+    ASSERT_EQ(runs, 5u);
+    ASSERT_TRUE(sameBits(canvas, expected));
+}
+
+TEST(progressiveRenderer, should_reject_a_checkpoint_of_another_size)
+{
+    const auto scene = testScene();
+    const auto camera = testCamera();
+    const Renderer renderer{scene, camera};
+    ProgressiveSettings settings;
+    settings.checkpoint = "./test_progressive.checkpoint";
+    SampleBuffer{camera.hsize() + 1, camera.vsize()}.save(settings.checkpoint);
+    ThreadPool pool{1};
+    Canvas canvas{camera.hsize(), camera.vsize()};
+    ASSERT_THROW(ProgressiveRenderer(renderer, settings).render(canvas, pool), std::runtime_error);
+    std::filesystem::remove(settings.checkpoint);
+}
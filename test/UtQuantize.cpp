@@ -0,0 +1,124 @@
+#include "Color.hpp"
+#include "PixelFormat.hpp"
+#include "Quantize.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
+namespace
+{
+auto testRow(std::size_t count) -> std::vector<Color>
+{
+    std::vector<Color> row;
+    for (std::size_t x{0}; x < count; ++x) {
+        const auto t = static_cast<float>(x)/static_cast<float>(count);
+        row.emplace_back(1.2f*t - 0.1f, t*t, static_cast<float>((x*37) % 256)/255.f);
+    }
+    return row;
+}
+
+auto linearCode(float value, float maxValue) -> int
+{
+    const auto clamped = std::isnan(value) ? 0.f : std::fmin(std::fmax(value, 0.f), 1.f);
+    return static_cast<int>(clamped*maxValue + 0.5f);
+}
+
+auto exactSrgb(float value) -> double
+{
+    const auto clamped = std::isnan(value) ? 0.0 : std::fmin(std::fmax(static_cast<double>(value), 0.0), 1.0);
+    return clamped <= 0.0031308 ? 12.92*clamped : 1.055*std::pow(clamped, 1.0/2.4) - 0.055;
+}
+}
+
+TEST(quantize, linear_row_should_round_to_nearest_code)
+{
+    // widths around the block and group sizes, writing nothing past the row
+    for (const auto count: {std::size_t{1}, std::size_t{3}, std::size_t{4}, std::size_t{63},
+                            std::size_t{64}, std::size_t{65}, std::size_t{130}}) {
+        auto row = testRow(count);
+        // at(), as row[0] makes gcc 12 report -Wnull-dereference for the
+        // empty vector testRow(0) would return, now that Color is inline
+        row.at(0) = Color{std::numeric_limits<float>::quiet_NaN(), 2.f, -1.f};
+        std::vector<std::uint8_t> out(3*count + 4, 0xaa);
+        quantizeRow8(row.data(), count, 0, Quantization{}, out.data());
+        for (std::size_t x{0}; x < count; ++x) {
+            ASSERT_EQ(out[3*x], linearCode(row[x].r(), 255.f)) << count << " " << x;
+            ASSERT_EQ(out[3*x + 1], linearCode(row[x].g(), 255.f)) << count << " " << x;
+            ASSERT_EQ(out[3*x + 2], linearCode(row[x].b(), 255.f)) << count << " " << x;
+        }
+        for (auto i = 3*count; i < out.size(); ++i) {
+            ASSERT_EQ(out[i], 0xaa);
+        }
+    }
+}
+
+TEST(quantize, sixteen_bit_codes_are_stored_most_significant_byte_first)
+{
+    const auto row = testRow(70);
+    std::vector<std::uint8_t> out(6*row.size() + 2, 0xaa);
+    quantizeRow16(row.data(), row.size(), 3, Quantization{}, out.data());
+    for (std::size_t x{0}; x < row.size(); ++x) {
+        for (std::size_t channel{0}; channel < 3; ++channel) {
+            const auto value = channel == 0 ? row[x].r() : channel == 1 ? row[x].g() : row[x].b();
+            const auto code = out[6*x + 2*channel] << 8 | out[6*x + 2*channel + 1];
+            ASSERT_EQ(code, linearCode(value, 65535.f)) << x;
+        }
+    }
+    ASSERT_EQ(out[6*row.size()], 0xaa);
+}
+
+TEST(quantize, srgb_should_stay_within_one_code_of_the_exact_curve)
+{
+    std::vector<Color> row;
+    for (std::size_t i{0}; i < 4096; ++i) {
+        const auto value = static_cast<float>(i)/4095.f;
+        row.emplace_back(value, value*value*value, std::sqrt(value));
+    }
+    std::vector<std::uint8_t> out8(3*row.size());
+    std::vector<std::uint8_t> out16(6*row.size());
+    quantizeRow8(row.data(), row.size(), 0, Quantization{true, false}, out8.data());
+    quantizeRow16(row.data(), row.size(), 0, Quantization{true, false}, out16.data());
+    for (std::size_t x{0}; x < row.size(); ++x) {
+        const float channels[3]{row[x].r(), row[x].g(), row[x].b()};
+        for (std::size_t channel{0}; channel < 3; ++channel) {
+            const auto code16 = out16[6*x + 2*channel] << 8 | out16[6*x + 2*channel + 1];
+            ASSERT_LE(std::abs(out8[3*x + channel] - encodeSrgb8(channels[channel])), 1) << x;
+            ASSERT_LE(std::abs(code16 - exactSrgb(channels[channel])*65535.0), 1.0) << x;
+        }
+    }
+    // linear values of exact sRGB codes come back as those codes
+    std::vector<Color> codes;
+    for (std::size_t code{0}; code < 256; ++code) {
+        const auto linear = decodeSrgb8(static_cast<std::uint8_t>(code));
+        codes.emplace_back(linear, linear, linear);
+    }
+    quantizeRow8(codes.data(), codes.size(), 0, Quantization{true, false}, out8.data());
+    for (std::size_t code{0}; code < 256; ++code) {
+        ASSERT_EQ(out8[3*code], code);
+    }
+}
+
+TEST(quantize, ordered_dither_should_keep_the_average_level)
+{
+    // a quarter of the way from code 100 to 101
+    const auto value = 100.25f/255.f;
+    const std::vector<Color> row(4, Color{value, 100.f/255.f, 1.f});
+    std::size_t roundedUp{0};
+    for (std::size_t y{0}; y < 4; ++y) {
+        std::vector<std::uint8_t> out(12);
+        quantizeRow8(row.data(), row.size(), y, Quantization{false, true}, out.data());
+        for (std::size_t x{0}; x < 4; ++x) {
+            ASSERT_TRUE(out[3*x] == 100 || out[3*x] == 101);
+            roundedUp += out[3*x] == 101 ? 1u : 0u;
+            // exact codes are never moved by the threshold
+            ASSERT_EQ(out[3*x + 1], 100);
+            ASSERT_EQ(out[3*x + 2], 255);
+        }
+    }
+    ASSERT_EQ(roundedUp, 4);
+}
@@ -1,6 +1,7 @@
 #include "Ray.hpp"
 #include "Point.hpp"
 #include "Vector.hpp"
+#include "Transformations.hpp"
 
 #include "gtest/gtest.h"
 
@@ -25,3 +26,19 @@ TEST(ray, calculate_position)
     expectedResult.at(0) = 4.5f;
     ASSERT_EQ(r.position(2.5f), expectedResult);
 }
+
+TEST(ray, translating_a_ray)
+{
+    const Ray r{Point4{1.f, 2.f, 3.f, 1.f}, Vec4{0.f, 1.f, 0.f, 0.f}};
+    const auto r2 = r.transform(translation(3.f, 4.f, 5.f));
+    ASSERT_EQ(r2.origin(), (Point4{4.f, 6.f, 8.f, 1.f}));
+    ASSERT_EQ(r2.direction(), (Vec4{0.f, 1.f, 0.f, 0.f}));
+}
+
+TEST(ray, scaling_a_ray)
+{
+    const Ray r{Point4{1.f, 2.f, 3.f, 1.f}, Vec4{0.f, 1.f, 0.f, 0.f}};
+    const auto r2 = r.transform(scaling(2.f, 3.f, 4.f));
+    ASSERT_EQ(r2.origin(), (Point4{2.f, 6.f, 12.f, 1.f}));
+    ASSERT_EQ(r2.direction(), (Vec4{0.f, 3.f, 0.f, 0.f}));
+}
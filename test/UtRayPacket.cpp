@@ -0,0 +1,98 @@
+#include "RayPacket.hpp"
+#include "Camera.hpp"
+#include "MathConsts.hpp"
+#include "Sphere.hpp"
+#include "Transformations.hpp"
+
+#include "gtest/gtest.h"
+
+namespace
+{
+template<std::size_t lanes>
+auto checkPacketMatchesSingleRays(const Sphere& sphere, const Camera& camera) -> std::size_t
+{
+    std::size_t hitCount{0};
+    for (std::size_t y{0}; y < camera.vsize(); ++y) {
+        for (std::size_t x{0}; x + lanes <= camera.hsize(); x += lanes) {
+            RayPacket<lanes> packet;
+            for (std::size_t lane{0}; lane < lanes; ++lane) {
+                packet.setRay(lane, camera.rayForPixel(x + lane, y));
+            }
+            PacketHits<lanes> hits;
+            sphere.intersect(packet, hits, 3);
+            for (std::size_t lane{0}; lane < lanes; ++lane) {
+                Intersections xs;
+                xs.add(sphere.intersect(camera.rayForPixel(x + lane, y), 3));
+                const auto expected = xs.hit();
+                EXPECT_EQ(hits.hit(lane), expected.has_value());
+                if (expected) {
+                    ++hitCount;
+                    EXPECT_EQ(hits.t[lane], expected->t);
+                    EXPECT_EQ(hits.object[lane], 3);
+                }
+            }
+        }
+    }
+    return hitCount;
+}
+}
+
+TEST(ray_packet, intersects_sphere_in_every_lane)
+{
+    RayPacket<4> packet;
+    for (std::size_t lane{0}; lane < 4; ++lane) {
+        packet.setRay(lane, Ray{Point4{0.f, 0.f, -5.f, 1.f}, Vec4{0.f, 0.f, 1.f, 0.f}});
+    }
+    packet.setRay(3, Ray{Point4{0.f, 2.f, -5.f, 1.f}, Vec4{0.f, 0.f, 1.f, 0.f}});
+    packet.setRay(2, Ray{Point4{0.f, 0.f, 0.f, 1.f}, Vec4{0.f, 0.f, 1.f, 0.f}});
+    const auto sphere = Sphere();
+    PacketHits<4> hits;
+    sphere.intersect(packet, hits, 5);
+    ASSERT_EQ(hits.t[0], 4.f);
+    ASSERT_EQ(hits.t[1], 4.f);
+    ASSERT_EQ(hits.t[2], 1.f);
+    ASSERT_FALSE(hits.hit(3));
+    ASSERT_EQ(hits.object[0], 5);
+}
+
+TEST(ray_packet, inactive_lanes_are_not_updated)
+{
+    RayPacket<8> packet;
+    packet.setRay(0, Ray{Point4{0.f, 0.f, -5.f, 1.f}, Vec4{0.f, 0.f, 1.f, 0.f}});
+    PacketHits<8> hits;
+    Sphere().intersect(packet, hits, 0);
+    ASSERT_TRUE(hits.hit(0));
+    for (std::size_t lane{1}; lane < 8; ++lane) {
+        ASSERT_FALSE(hits.hit(lane));
+    }
+}
+
+TEST(ray_packet, keeps_nearest_hit_across_spheres)
+{
+    RayPacket<4> packet;
+    packet.setRay(0, Ray{Point4{0.f, 0.f, -5.f, 1.f}, Vec4{0.f, 0.f, 1.f, 0.f}});
+    auto near = Sphere();
+    auto far = Sphere();
+    far.setTransform(translation(0.f, 0.f, 3.f));
+    PacketHits<4> hits;
+    far.intersect(packet, hits, 1);
+    near.intersect(packet, hits, 0);
+    ASSERT_EQ(hits.t[0], 4.f);
+    ASSERT_EQ(hits.object[0], 0);
+}
+
+TEST(ray_packet, lanes_should_match_single_ray_intersection)
+{
+    Camera camera{64, 48, mathConst::pi/3.f};
+    camera.setTransform(view_transform(Point4{0.f, 0.f, -5.f, 1.f},
+                                      Point4{0.f, 0.f, 0.f, 1.f},
+                                      Vec4{0.f, 1.f, 0.f, 0.f}));
+    auto sphere = Sphere();
+    sphere.setTransform(TransformationStacker().scale(1.5f, 0.7f, 1.f)
+                                               .rotate_z(0.4f)
+                                               .translate(0.3f, -0.2f, 0.f)
+                                               .getTransform());
+    ASSERT_GT(checkPacketMatchesSingleRays<4>(sphere, camera), 0);
+    ASSERT_GT(checkPacketMatchesSingleRays<8>(sphere, camera), 0);
+    ASSERT_GT(checkPacketMatchesSingleRays<16>(sphere, camera), 0);
+}
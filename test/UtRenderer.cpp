@@ -0,0 +1,169 @@
+#include "Renderer.hpp"
+#include "Camera.hpp"
+#include "Canvas.hpp"
+#include "Color.hpp"
+#include "MathConsts.hpp"
+#include "SampleBuffer.hpp"
+#include "Scene.hpp"
+#include "Sphere.hpp"
+#include "ThreadPool.hpp"
+#include "Transformations.hpp"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+auto testScene() -> Scene
+{
+    Scene scene;
+    scene.add(Sphere());
+    auto small = Sphere();
+    small.setTransform(TransformationStacker().scale(0.5f, 0.5f, 0.5f)
+                                              .translate(1.5f, 0.5f, -0.5f)
+                                              .getTransform());
+    scene.add(small);
+    auto flat = Sphere();
+    flat.setTransform(TransformationStacker().scale(2.f, 0.2f, 2.f)
+                                             .translate(0.f, -1.f, 0.f)
+                                             .getTransform());
+    scene.add(flat);
+    return scene;
+}
+
+auto testCamera() -> Camera
+{
+    Camera camera{37, 23, mathConst::pi/3.f};
+    camera.setTransform(view_transform(Point4{0.f, 1.f, -6.f, 1.f},
+                                      Point4{0.f, 0.f, 0.f, 1.f},
+                                      Vec4{0.f, 1.f, 0.f, 0.f}));
+    return camera;
+}
+
+auto expectSameCanvas(const Canvas& lhs, const Canvas& rhs) -> void
+{
+    for (std::size_t y{0}; y < lhs.height(); ++y) {
+        for (std::size_t x{0}; x < lhs.width(); ++x) {
+            ASSERT_EQ(lhs.getPixel(x, y), rhs.getPixel(x, y)) << x << "," << y;
+        }
+    }
+}
+}
+
+TEST(renderer, renders_hits_and_background)
+{
+    const auto scene = testScene();
+    const auto camera = testCamera();
+    const RenderSettings settings{Color{1.f, 0.f, 0.f}, Color{0.f, 0.f, 1.f}};
+    Canvas canvas{camera.hsize(), camera.vsize()};
+    Renderer{scene, camera, settings}.render(canvas);
+    ASSERT_EQ(canvas.getPixel(18, 11), settings.hitColor);
+    ASSERT_EQ(canvas.getPixel(0, 0), settings.background);
+}
+
+TEST(renderer, packet_paths_should_match_single_ray_path)
+{
+    const auto scene = testScene();
+    const auto camera = testCamera();
+    const Renderer renderer{scene, camera};
+    Canvas expected{camera.hsize(), camera.vsize()};
+    renderer.render(expected);
+
+    Canvas canvas{camera.hsize(), camera.vsize()};
+    renderer.renderPackets<4>(canvas);
+    expectSameCanvas(canvas, expected);
+    renderer.renderPackets<8>(canvas);
+    expectSameCanvas(canvas, expected);
+    renderer.renderPackets<16>(canvas);
+    expectSameCanvas(canvas, expected);
+}
+
+TEST(renderer, tiles_cover_canvas_once)
+{
+    const auto scene = testScene();
+    const auto camera = testCamera();
+    RenderSettings settings;
+    settings.tileSize = 8;
+    const Renderer renderer{scene, camera, settings};
+    const Canvas canvas{camera.hsize(), camera.vsize()};
+    ASSERT_EQ(renderer.tileCount(canvas), 5*3);
+    std::vector<int> covered(canvas.width()*canvas.height());
+    for (std::size_t index{0}; index < renderer.tileCount(canvas); ++index) {
+        const auto tile = renderer.tile(canvas, index);
+        for (auto y = tile.y; y < tile.y + tile.height; ++y) {
+            for (auto x = tile.x; x < tile.x + tile.width; ++x) {
+                ++covered[y*canvas.width() + x];
+            }
+        }
+    }
+    ASSERT_EQ(std::count(covered.begin(), covered.end(), 1), covered.size());
+}
+
+TEST(renderer, threaded_rendering_should_match_single_thread)
+{
+    auto scene = testScene();
+    scene.build();
+    const auto camera = testCamera();
+    Canvas expected{camera.hsize(), camera.vsize()};
+    Renderer{scene, camera}.render(expected);
+
+    RenderSettings settings;
+    settings.tileSize = 7;
+    const Renderer renderer{scene, camera, settings};
+    for (const auto threads: {std::size_t{1}, std::size_t{3}}) {
+        ThreadPool pool{threads};
+        Canvas canvas{camera.hsize(), camera.vsize()};
+        renderer.render(canvas, pool);
+        expectSameCanvas(canvas, expected);
+        Canvas packets{camera.hsize(), camera.vsize()};
+        renderer.renderPackets<8>(packets, pool);
+        expectSameCanvas(packets, expected);
+    }
+}
+
+TEST(renderer, should_reject_canvas_of_different_size)
+{
+    const auto scene = testScene();
+    const auto camera = testCamera();
+    Canvas canvas{10, 10};
+    ASSERT_THROW(Renderer(scene, camera).render(canvas), std::runtime_error);
+}
+
+TEST(renderer, accumulated_samples_should_not_depend_on_how_they_are_split)
+{
+    auto scene = testScene();
+    scene.build();
+    const auto camera = testCamera();
+    const Renderer renderer{scene, camera};
+    Canvas expected{camera.hsize(), camera.vsize()};
+    renderer.render(expected);
+
+    // one sample per pixel is the centre ray render() traces
+    SampleBuffer once{camera.hsize(), camera.vsize()};
+    renderer.accumulate(once, 1);
+    Canvas canvas{camera.hsize(), camera.vsize()};
+    once.resolve(canvas);
+    expectSameCanvas(canvas, expected);
+
+    renderer.accumulate(once, 8);
+    SampleBuffer split{camera.hsize(), camera.vsize()};
+    ThreadPool pool{3};
+    renderer.accumulate(split, 3, pool);
+    renderer.accumulate(split, 8, pool);
+    renderer.accumulate(split, 5, pool);
+    for (std::size_t y{0}; y < camera.vsize(); ++y) {
+        for (std::size_t x{0}; x < camera.hsize(); ++x) {
+            ASSERT_EQ(split.samples(x, y), 8u);
+            ASSERT_EQ(std::memcmp(&split.sum(x, y), &once.sum(x, y), sizeof(Color)), 0) << x << "," << y;
+        }
+    }
+    // jittered samples blend the colours along silhouettes
+    once.resolve(canvas);
+    ASSERT_GT(std::count_if(canvas.begin(), canvas.end(), [](const auto& pixel) {
+        const Color color = pixel.color;
+        return color.r() > 0.f && color.r() < 1.f;
+    }), 0);
+}
@@ -0,0 +1,82 @@
+#include "SampleBuffer.hpp"
+#include "Canvas.hpp"
+#include "Color.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+TEST(sampleBuffer, resolve_should_average_the_samples)
+{
+    SampleBuffer buffer{3, 2};
+    ASSERT_EQ(buffer.minSamples(), 0u);
+    buffer.add(0, 0, Color{1.f, 0.f, 0.5f});
+    buffer.add(0, 0, Color{0.f, 0.f, 0.5f});
+    buffer.add(2, 1, Color{0.2f, 0.4f, 0.6f});
+    ASSERT_EQ(buffer.samples(0, 0), 2u);
+    ASSERT_EQ(buffer.sum(0, 0), Color(1.f, 0.f, 1.f));
+
+    Canvas canvas{3, 2, Color{1.f, 1.f, 1.f}};
+    buffer.resolve(canvas);
+    ASSERT_EQ(canvas.getPixel(0, 0), Color(0.5f, 0.f, 0.5f));
+    ASSERT_EQ(canvas.getPixel(2, 1), Color(0.2f, 0.4f, 0.6f));
+    ASSERT_EQ(canvas.getPixel(1, 0), Color(0.f, 0.f, 0.f));
+
+    Canvas other{2, 3};
+    ASSERT_THROW(buffer.resolve(other), std::runtime_error);
+}
+
+TEST(sampleBuffer, checkpoint_should_restore_every_bit)
+{
+    SampleBuffer buffer{5, 4};
+    for (std::size_t y{0}; y < 4; ++y) {
+        for (std::size_t x{0}; x < 5; ++x) {
+            for (std::size_t sample{0}; sample <= (x + y) % 3; ++sample) {
+                buffer.add(x, y, Color{0.1f*static_cast<float>(x), 1.f/3.f, 0.7f*static_cast<float>(sample)});
+            }
+        }
+    }
+    const std::filesystem::path checkpoint{"./test_samples.checkpoint"};
+    buffer.save(checkpoint);
+    ASSERT_EQ(std::filesystem::file_size(checkpoint), 24u + 20u*16u);
+
+    const auto loaded = SampleBuffer::load(checkpoint);
+    ASSERT_EQ(loaded.width(), 5u);
+    ASSERT_EQ(loaded.height(), 4u);
+    ASSERT_EQ(loaded.minSamples(), 1u);
+    for (std::size_t y{0}; y < 4; ++y) {
+        for (std::size_t x{0}; x < 5; ++x) {
+            ASSERT_EQ(loaded.samples(x, y), buffer.samples(x, y));
+            ASSERT_EQ(std::memcmp(&loaded.sum(x, y), &buffer.sum(x, y), sizeof(Color)), 0);
+        }
+    }
+    std::filesystem::remove(checkpoint);
+}
+
+TEST(sampleBuffer, load_should_reject_anything_but_a_complete_checkpoint)
+{
+    const std::filesystem::path checkpoint{"./test_samples.checkpoint"};
+    ASSERT_THROW(SampleBuffer::load(checkpoint), std::runtime_error);
+    SampleBuffer{4, 4}.save(checkpoint);
+    std::filesystem::resize_file(checkpoint, std::filesystem::file_size(checkpoint) - 1);
+    ASSERT_THROW(SampleBuffer::load(checkpoint), std::runtime_error);
+    {
+        std::ofstream file{checkpoint, std::ios::binary | std::ios::trunc};
+        file << "P3\n4 4\n255\n";
+    }
+    ASSERT_THROW(SampleBuffer::load(checkpoint), std::runtime_error);
+    // 16 bytes for each of 2^60 + 4 pixels wrap around to those of 4
+    SampleBuffer{4, 1}.save(checkpoint);
+    {
+        const std::uint64_t width{(std::uint64_t{1} << 60) + 4};
+        std::fstream file{checkpoint, std::ios::binary | std::ios::in | std::ios::out};
+        file.seekp(8);
+        file.write(reinterpret_cast<const char*>(&width), sizeof(width));
+    }
+    ASSERT_THROW(SampleBuffer::load(checkpoint), std::runtime_error);
+    std::filesystem::remove(checkpoint);
+}
@@ -0,0 +1,47 @@
+#include "SceneGenerator.hpp"
+#include "Canvas.hpp"
+#include "Renderer.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+
+TEST(sceneGenerator, same_seed_should_give_the_same_scene)
+{
+    const SceneSpec spec{500, 7};
+    const auto scene = generateScene(spec);
+    const auto again = generateScene(spec);
+    const auto other = generateScene(SceneSpec{500, 8});
+    ASSERT_EQ(scene.spheres().size(), 500u);
+    ASSERT_FALSE(scene.accelerated());
+    std::size_t moved{0};
+    const auto half = std::cbrt(500.f)/2.f;
+    for (std::size_t id{0}; id < scene.spheres().size(); ++id) {
+        ASSERT_EQ(scene.spheres().center(id), again.spheres().center(id));
+        ASSERT_EQ(scene.spheres().radius(id), again.spheres().radius(id));
+        moved += scene.spheres().center(id) == other.spheres().center(id) ? 0u : 1u;
+        ASSERT_GE(scene.spheres().radius(id), spec.minRadius*0.999f);
+        ASSERT_LE(scene.spheres().radius(id), spec.maxRadius*1.001f);
+        for (std::size_t axis{0}; axis < 3; ++axis) {
+            ASSERT_LE(std::abs(scene.spheres().center(id)[axis]), half);
+        }
+    }
+    ASSERT_EQ(moved, 500u);
+}
+
+TEST(sceneGenerator, camera_should_see_the_scene)
+{
+    const SceneSpec spec{2000};
+    auto scene = generateScene(spec);
+    scene.build();
+    const auto camera = generatedSceneCamera(spec, 32, 18);
+    ASSERT_EQ(camera.hsize(), 32u);
+    ASSERT_EQ(camera.vsize(), 18u);
+    Canvas canvas{32, 18};
+    Renderer{scene, camera}.render(canvas);
+    std::size_t hits{0};
+    for (const auto& pixel: canvas) {
+        hits += pixel.color == Color(1.f, 1.f, 1.f) ? 1u : 0u;
+    }
+    ASSERT_GT(hits, 32u*18u/2u);
+}
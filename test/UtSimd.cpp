@@ -0,0 +1,56 @@
+#include "Simd.hpp"
+#include "Color.hpp"
+#include "Point.hpp"
+#include "Vector.hpp"
+
+#include "gtest/gtest.h"
+
+TEST(simd, lane_arithmetic_should_match_scalar_math)
+{
+    alignas(16) const float lhs[4]{1.f, -2.f, 3.f, 0.5f};
+    alignas(16) const float rhs[4]{4.f, 5.f, -6.f, 2.f};
+    alignas(16) float result[4]{};
+
+    simd::store(result, simd::add(simd::load(lhs), simd::load(rhs)));
+    EXPECT_EQ(result[0], 5.f);
+    EXPECT_EQ(result[3], 2.5f);
+    simd::store(result, simd::sub(simd::load(lhs), simd::load(rhs)));
+    EXPECT_EQ(result[1], -7.f);
+    simd::store(result, simd::mul(simd::load(lhs), simd::broadcast(2.f)));
+    EXPECT_EQ(result[2], 6.f);
+    simd::store(result, simd::div(simd::load(lhs), simd::load(rhs)));
+    EXPECT_EQ(result[3], 0.25f);
+    simd::store(result, simd::negate(simd::load(lhs)));
+    EXPECT_EQ(result[1], 2.f);
+    EXPECT_EQ(simd::dot(simd::load(lhs), simd::load(rhs)), -23.f);
+}
+
+TEST(simd, four_component_types_should_be_16_byte_aligned)
+{
+    EXPECT_EQ(alignof(Vec4), 16);
+    EXPECT_EQ(alignof(Point4), 16);
+    EXPECT_EQ(alignof(Color), 16);
+}
+
+TEST(simd, vec4_operations)
+{
+    Vec4 v1{1.f, 2.f, 3.f, 0.f};
+    Vec4 v2{2.f, 3.f, 4.f, 0.f};
+    EXPECT_EQ(dotProduct(v1, v2), 20.f);
+    EXPECT_EQ(v1+v2, (Vec4{3.f, 5.f, 7.f, 0.f}));
+    EXPECT_EQ(v1-v2, (Vec4{-1.f, -1.f, -1.f, 0.f}));
+    EXPECT_EQ(-v1, (Vec4{-1.f, -2.f, -3.f, 0.f}));
+    EXPECT_EQ(v1*2.f, (Vec4{2.f, 4.f, 6.f, 0.f}));
+    EXPECT_EQ(magnitude(Vec4{0.f, 3.f, 4.f, 0.f}), 5.f);
+    EXPECT_EQ(normalize(Vec4{4.f, 0.f, 0.f, 0.f}), (Vec4{1.f, 0.f, 0.f, 0.f}));
+}
+
+TEST(simd, point4_operations)
+{
+    Point4 p1{3.f, 2.f, 1.f, 1.f};
+    Point4 p2{5.f, 6.f, 7.f, 1.f};
+    Vec4 v{1.f, 1.f, 1.f, 0.f};
+    EXPECT_EQ(p1-p2, (Vec4{-2.f, -4.f, -6.f, 0.f}));
+    EXPECT_EQ(p1-v, (Point4{2.f, 1.f, 0.f, 1.f}));
+    EXPECT_EQ(v+p1, (Point4{4.f, 3.f, 2.f, 1.f}));
+}
@@ -8,48 +8,99 @@
 
 #include <vector>
 
-TEST(sphere, get_id)
+namespace
 {
-    auto s1 = Sphere();
-    auto s2 = Sphere();
-    auto s3 = Sphere();
-
-    ASSERT_EQ(s1.id(), 0);
-    ASSERT_EQ(s2.id(), 1);
-    ASSERT_EQ(s3.id(), 2);
+auto tValues(const ObjectIntersections& intersections) -> std::vector<float>
+{
+    std::vector<float> values;
+    for (const auto& intersection: intersections) {
+        values.push_back(intersection.t);
+    }
+    return values;
+}
 }
 
 TEST(sphere, intersect_with_ray_at_two_points)
 {
     const auto ray = Ray{Point4{0.f, 0.f, -5.f, 1.f}, Vec4{0.f, 0.f, 1.f, 0.f}};
     const auto sphere = Sphere();
-    ASSERT_THAT(sphere.intersect(ray), ::testing::ElementsAre(4.f, 6.f));
+    ASSERT_THAT(tValues(sphere.intersect(ray, 0)), ::testing::ElementsAre(4.f, 6.f));
+}
+
+TEST(sphere, intersections_should_carry_given_id)
+{
+    const auto ray = Ray{Point4{0.f, 0.f, -5.f, 1.f}, Vec4{0.f, 0.f, 1.f, 0.f}};
+    const auto sphere = Sphere();
+    const auto intersections = sphere.intersect(ray, 7);
+    ASSERT_EQ(intersections.size(), 2);
+    ASSERT_EQ(intersections[0].object, 7);
+    ASSERT_EQ(intersections[1].object, 7);
 }
 
 TEST(sphere, intersect_with_ray_at_one_point)
 {
     const auto ray = Ray{Point4{0.f, 1.f, -5.f, 1.f}, Vec4{0.f, 0.f, 1.f, 0.f}};
     const auto sphere = Sphere();
-    ASSERT_THAT(sphere.intersect(ray), ::testing::ElementsAre(5.f, 5.f));
+    ASSERT_THAT(tValues(sphere.intersect(ray, 0)), ::testing::ElementsAre(5.f, 5.f));
 }
 
 TEST(sphere, does_not_intersect_with_ray)
 {
     const auto ray = Ray{Point4{0.f, 2.f, -5.f, 1.f}, Vec4{0.f, 0.f, 1.f, 0.f}};
     const auto sphere = Sphere();
-    ASSERT_TRUE(sphere.intersect(ray).empty()); 
+    ASSERT_TRUE(sphere.intersect(ray, 0).empty()); 
 }
 
 TEST(sphere, intersects_at_two_points_when_ray_source_is_inside_sphere)
 {
     const auto ray = Ray{Point4{0.f, 0.f, 0.f, 1.f}, Vec4{0.f, 0.f, 1.f, 0.f}};
     const auto sphere = Sphere();
-    ASSERT_THAT(sphere.intersect(ray), ::testing::ElementsAre(-1.f, 1.f));
+    ASSERT_THAT(tValues(sphere.intersect(ray, 0)), ::testing::ElementsAre(-1.f, 1.f));
 }
 
 TEST(sphere, intersects_at_two_points_when_sphere_is_behind_ray_origin)
 {
     const auto ray = Ray{Point4{0.f, 0.f, 5.f, 1.f}, Vec4{0.f, 0.f, 1.f, 0.f}};
     const auto sphere = Sphere();
-    ASSERT_THAT(sphere.intersect(ray), ::testing::ElementsAre(-6.f, -4.f));
+    ASSERT_THAT(tValues(sphere.intersect(ray, 0)), ::testing::ElementsAre(-6.f, -4.f));
+}
+
+TEST(sphere, default_transformation_is_identity)
+{
+    const auto sphere = Sphere();
+    ASSERT_EQ(sphere.transform().matrix(), matrix::identity4);
+    ASSERT_EQ(sphere.transform().inverse(), matrix::identity4);
+}
+
+TEST(sphere, intersect_scaled_sphere_with_ray)
+{
+    const auto ray = Ray{Point4{0.f, 0.f, -5.f, 1.f}, Vec4{0.f, 0.f, 1.f, 0.f}};
+    auto sphere = Sphere();
+    sphere.setTransform(scaling(2.f, 2.f, 2.f));
+    ASSERT_THAT(tValues(sphere.intersect(ray, 0)), ::testing::ElementsAre(3.f, 7.f));
+}
+
+TEST(sphere, intersect_translated_sphere_with_ray)
+{
+    const auto ray = Ray{Point4{0.f, 0.f, -5.f, 1.f}, Vec4{0.f, 0.f, 1.f, 0.f}};
+    auto sphere = Sphere();
+    sphere.setTransform(translation(5.f, 0.f, 0.f));
+    ASSERT_TRUE(sphere.intersect(ray, 0).empty());
+}
+
+TEST(sphere, bounds_enclose_transformed_sphere)
+{
+    auto sphere = Sphere();
+    sphere.setTransform(TransformationStacker().scale(2.f, 1.f, 0.5f)
+                                               .translate(1.f, -2.f, 3.f)
+                                               .getTransform());
+    const auto box = sphere.bounds();
+    ASSERT_NEAR(box.min[0], -1.f, 1e-4f);
+    ASSERT_NEAR(box.max[0], 3.f, 1e-4f);
+    ASSERT_NEAR(box.min[1], -3.f, 1e-4f);
+    ASSERT_NEAR(box.max[1], -1.f, 1e-4f);
+    ASSERT_NEAR(box.min[2], 2.5f, 1e-4f);
+    ASSERT_NEAR(box.max[2], 3.5f, 1e-4f);
+    ASSERT_LE(box.min[0], -1.f);
+    ASSERT_GE(box.max[0], 3.f);
 }
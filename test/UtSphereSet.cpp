@@ -0,0 +1,113 @@
+#include "SphereSet.hpp"
+#include "Camera.hpp"
+#include "MathConsts.hpp"
+#include "Point.hpp"
+#include "Ray.hpp"
+#include "Sphere.hpp"
+#include "Transformations.hpp"
+#include "Vector.hpp"
+
+#include "gtest/gtest.h"
+
+namespace
+{
+auto sphereAt(float x, float y, float z, float scale) -> Sphere
+{
+    auto sphere = Sphere();
+    sphere.setTransform(TransformationStacker().scale(scale, scale, scale)
+                                               .translate(x, y, z)
+                                               .getTransform());
+    return sphere;
+}
+}
+
+TEST(sphere_set, ids_are_dense_indices)
+{
+    SphereSet set;
+    ASSERT_TRUE(set.empty());
+    ASSERT_EQ(set.add(Sphere()), 0);
+    ASSERT_EQ(set.add(Sphere()), 1);
+    ASSERT_EQ(set.add(Sphere()), 2);
+    ASSERT_EQ(set.size(), 3);
+}
+
+TEST(sphere_set, keeps_bounding_center_and_radius)
+{
+    SphereSet set;
+    set.add(sphereAt(1.f, 2.f, 3.f, 0.5f));
+    auto stretched = Sphere();
+    stretched.setTransform(TransformationStacker().scale(3.f, 1.f, 1.f)
+                                                  .rotate_z(mathConst::pi/4.f)
+                                                  .getTransform());
+    set.add(stretched);
+    ASSERT_EQ(set.center(0), (Point4{1.f, 2.f, 3.f, 1.f}));
+    ASSERT_FLOAT_EQ(set.radius(0), 0.5f);
+    ASSERT_EQ(set.center(1), (Point4{0.f, 0.f, 0.f, 1.f}));
+    ASSERT_FLOAT_EQ(set.radius(1), 3.f);
+}
+
+TEST(sphere_set, nearest_returns_closest_sphere_in_front_of_ray)
+{
+    SphereSet set;
+    set.add(sphereAt(0.f, 0.f, 6.f, 1.f));
+    set.add(sphereAt(0.f, 0.f, 0.f, 1.f));
+    set.add(sphereAt(0.f, 0.f, -10.f, 1.f));
+    const auto hit = set.nearest(Ray{Point4{0.f, 0.f, -5.f, 1.f}, Vec4{0.f, 0.f, 1.f, 0.f}});
+    ASSERT_TRUE(hit);
+    ASSERT_EQ(*hit, (Intersection{4.f, 1}));
+}
+
+TEST(sphere_set, nearest_misses)
+{
+    const auto ray = Ray{Point4{0.f, 0.f, -5.f, 1.f}, Vec4{0.f, 0.f, 1.f, 0.f}};
+    SphereSet set;
+    ASSERT_FALSE(set.nearest(ray));
+    set.add(sphereAt(3.f, 0.f, 0.f, 1.f));
+    ASSERT_FALSE(set.nearest(ray));
+}
+
+TEST(sphere_set, nearest_prefers_lowest_id_on_tie)
+{
+    SphereSet set;
+    for (std::size_t i{0}; i < SphereSet::width + 3; ++i) {
+        set.add(sphereAt(i < 5 ? 5.f : 0.f, 0.f, 0.f, 1.f));
+    }
+    const auto hit = set.nearest(Ray{Point4{0.f, 0.f, -5.f, 1.f}, Vec4{0.f, 0.f, 1.f, 0.f}});
+    ASSERT_TRUE(hit);
+    ASSERT_EQ(hit->object, 5);
+}
+
+TEST(sphere_set, nearest_should_match_scalar_hit)
+{
+    SphereSet set;
+    for (std::size_t i{0}; i < 2*SphereSet::width + 3; ++i) {
+        const auto f = static_cast<float>(i);
+        auto sphere = Sphere();
+        sphere.setTransform(TransformationStacker().scale(0.3f + 0.05f*f, 0.4f, 0.3f)
+                                                   .rotate_y(0.2f*f)
+                                                   .translate(-2.f + 0.2f*f, 0.1f*f - 1.f, 0.3f*f)
+                                                   .getTransform());
+        set.add(sphere);
+    }
+    Camera camera{48, 32, mathConst::pi/2.f};
+    camera.setTransform(view_transform(Point4{0.f, 0.f, -5.f, 1.f},
+                                      Point4{0.f, 0.f, 0.f, 1.f},
+                                      Vec4{0.f, 1.f, 0.f, 0.f}));
+    std::size_t hits{0};
+    Intersections xs;
+    for (std::size_t y{0}; y < camera.vsize(); ++y) {
+        for (std::size_t x{0}; x < camera.hsize(); ++x) {
+            const auto ray = camera.rayForPixel(x, y);
+            xs.clear();
+            set.intersect(ray, xs);
+            const auto expected = xs.hit();
+            const auto actual = set.nearest(ray);
+            ASSERT_EQ(actual.has_value(), expected.has_value()) << x << "," << y;
+            if (expected) {
+                ++hits;
+                ASSERT_EQ(*actual, *expected) << x << "," << y;
+            }
+        }
+    }
+    ASSERT_GT(hits, 0);
+}
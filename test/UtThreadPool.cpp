@@ -0,0 +1,67 @@
+#include "ThreadPool.hpp"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace
+{
+auto expectEveryIndexOnce(ThreadPool& pool, std::size_t count) -> void
+{
+    std::vector<std::atomic<int>> calls(count);
+    pool.run(count, [&](std::size_t index) { ++calls[index]; });
+    for (std::size_t index{0}; index < count; ++index) {
+        ASSERT_EQ(calls[index].load(), 1) << index;
+    }
+}
+}
+
+TEST(thread_pool, default_size_is_hardware_concurrency)
+{
+    ASSERT_GE(ThreadPool::defaultThreadCount(), 1);
+    ASSERT_EQ(ThreadPool().size(), ThreadPool::defaultThreadCount());
+    ASSERT_EQ(ThreadPool(0).size(), 1);
+}
+
+TEST(thread_pool, runs_every_task_exactly_once)
+{
+    for (const auto threads: {std::size_t{1}, std::size_t{2}, std::size_t{3}, std::size_t{8}}) {
+        ThreadPool pool{threads};
+        for (const auto count: {std::size_t{0}, std::size_t{1}, std::size_t{5}, std::size_t{1000}}) {
+            expectEveryIndexOnce(pool, count);
+        }
+    }
+}
+
+TEST(thread_pool, idle_workers_steal_from_busy_ones)
+{
+    ThreadPool pool{4};
+    constexpr std::size_t count{64};
+    std::vector<std::thread::id> ranOn(count);
+    pool.run(count, [&](std::size_t index) {
+        ranOn[index] = std::this_thread::get_id();
+        if (index < count/4) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+    });
+    // the first quarter is the calling thread's share, yet others helped
+    const std::set<std::thread::id> helpers(ranOn.begin(), ranOn.begin() + count/4);
+    ASSERT_GT(helpers.size(), 1);
+}
+
+TEST(thread_pool, rethrows_task_exception_and_stays_usable)
+{
+    ThreadPool pool{3};
+    ASSERT_THROW(pool.run(100, [](std::size_t index) {
+                     if (index == 42) {
+                         throw std::runtime_error("task failed");
+                     }
+                 }),
+                 std::runtime_error);
+    expectEveryIndexOnce(pool, 100);
+}
@@ -0,0 +1,125 @@
+#include "Trace.hpp"
+#include "Camera.hpp"
+#include "Canvas.hpp"
+#include "MathConsts.hpp"
+#include "Renderer.hpp"
+#include "Scene.hpp"
+#include "Sphere.hpp"
+#include "ThreadPool.hpp"
+#include "Transformations.hpp"
+
+#include "gtest/gtest.h"
+
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+auto occurrences(const std::string& text, const std::string& part) -> std::size_t
+{
+    std::size_t count{0};
+    for (auto at = text.find(part); at != std::string::npos; at = text.find(part, at + 1)) {
+        ++count;
+    }
+    return count;
+}
+}
+
+TEST(trace, should_record_a_span_per_tile_and_the_save)
+{
+    Scene scene;
+    scene.add(Sphere());
+    scene.build();
+    Camera camera{50, 30, mathConst::pi/3.f};
+    camera.setTransform(view_transform(Point4{0.f, 0.f, -5.f, 1.f},
+                                      Point4{0.f, 0.f, 0.f, 1.f},
+                                      Vec4{0.f, 1.f, 0.f, 0.f}));
+    RenderSettings settings;
+    settings.tileSize = 8;
+    const Renderer renderer{scene, camera, settings};
+    ThreadPool pool{3};
+    Canvas canvas{camera.hsize(), camera.vsize()};
+    const auto tracePath = std::filesystem::temp_directory_path()/"ray_tracer_trace.json";
+    const auto imagePath = std::filesystem::temp_directory_path()/"ray_tracer_trace.ppm";
+
+    // not recorded
+    renderer.render(canvas, pool);
+    ASSERT_FALSE(trace::recording());
+    trace::start();
+    ASSERT_TRUE(trace::recording());
+    renderer.render(canvas, pool);
+    canvas.saveToFile(imagePath);
+    trace::stop(tracePath);
+    ASSERT_FALSE(trace::recording());
+
+    std::stringstream content;
+    content << std::ifstream{tracePath}.rdbuf();
+    const auto json = content.str();
+    std::filesystem::remove(tracePath);
+    std::filesystem::remove(imagePath);
+    ASSERT_EQ(json.rfind("{\"traceEvents\": [", 0), 0u);
+    ASSERT_NE(json.find("], \"displayTimeUnit\": \"ms\", \"otherData\": {\"droppedSpans\": 0}}"),
+              std::string::npos);
+    // 7 by 4 tiles
+    ASSERT_EQ(occurrences(json, "\"name\": \"tile\""), 28u);
+    ASSERT_EQ(occurrences(json, "\"name\": \"render\""), 1u);
+    ASSERT_EQ(occurrences(json, "\"name\": \"save\""), 1u);
+    ASSERT_NE(json.find("\"args\": {\"index\": 27}"), std::string::npos);
+    std::set<std::size_t> tracks;
+    for (auto at = json.find("\"thread_name\""); at != std::string::npos; at = json.find("\"thread_name\"", at + 1)) {
+        tracks.insert(std::stoul(json.substr(json.find("\"tid\": ", at) + 7)));
+    }
+    ASSERT_GE(tracks.size(), 1u);
+    ASSERT_LE(tracks.size(), 3u);
+}
+
+TEST(trace, should_record_spans_while_recordings_start_and_stop)
+{
+    const auto tracePath = std::filesystem::temp_directory_path()/"ray_tracer_trace_restart.json";
+    std::vector<std::thread> threads;
+    for (auto t = 0; t < 3; ++t) {
+        threads.emplace_back([] {
+            for (std::int64_t i{0}; i < 20000; ++i) {
+                const trace::Span span{"work", i};
+            }
+        });
+    }
+    for (auto recording = 0; recording < 20; ++recording) {
+        trace::start();
+        std::this_thread::yield();
+        trace::stop(tracePath);
+    }
+    for (auto& thread: threads) {
+        thread.join();
+    }
+
+    std::stringstream content;
+    content << std::ifstream{tracePath}.rdbuf();
+    std::filesystem::remove(tracePath);
+    ASSERT_NE(content.str().find("\"otherData\": {\"droppedSpans\": 0}}"), std::string::npos);
+}
+
+TEST(trace, spans_past_the_capacity_of_a_thread_should_be_counted_as_dropped)
+{
+    const auto tracePath = std::filesystem::temp_directory_path()/"ray_tracer_trace_dropped.json";
+    trace::start();
+    std::thread{[] {
+        // a thread records up to 65536 spans per recording
+        for (auto i = 0; i < 65536 + 5; ++i) {
+            const trace::Span span{"many"};
+        }
+    }}.join();
+    trace::stop(tracePath);
+
+    std::stringstream content;
+    content << std::ifstream{tracePath}.rdbuf();
+    const auto json = content.str();
+    std::filesystem::remove(tracePath);
+    ASSERT_EQ(occurrences(json, "\"name\": \"many\""), 65536u);
+    ASSERT_NE(json.find("\"otherData\": {\"droppedSpans\": 5}}"), std::string::npos);
+}
@@ -121,3 +121,69 @@ TEST(transformations, transformations_stacking)
                                          .getMatrix();
     ASSERT_EQ(result*p, exp_result);
 }
+
+TEST(transformations, stacked_shearing_should_compose_with_previous_transformations)
+{
+    auto p = Point4{2.f, 3.f, 4.f, 1.f};
+    auto result = TransformationStacker().shear(1.f, 0.f, 0.f, 0.f, 0.f, 0.f)
+                                         .translate(1.f, 0.f, 0.f)
+                                         .getMatrix();
+    ASSERT_EQ(result*p, (Point4{6.f, 3.f, 4.f, 1.f}));
+}
+
+TEST(transformations, builders_should_be_usable_in_constant_expressions)
+{
+    constexpr auto transform = TransformationStacker().scale(2.f, 2.f, 2.f)
+                                                      .rotate_z(0.f, 1.f)
+                                                      .translate(1.f, 2.f, 3.f)
+                                                      .getMatrix();
+    constexpr auto p = transform*Point4{1.f, 0.f, 0.f, 1.f};
+    static_assert(p.get<0>() == 1.f && p.get<1>() == 4.f && p.get<2>() == 3.f);
+
+    constexpr auto inv = inverse(translation(5.f, -3.f, 2.f));
+    static_assert(inv.get<0, 3>() == -5.f && inv.get<1, 3>() == 3.f);
+
+    constexpr Transform cached{scaling(2.f, 4.f, 8.f)};
+    static_assert(cached.inverse().get<2, 2>() == 0.125f);
+    ASSERT_EQ(cached.matrix(), scaling(2.f, 4.f, 8.f));
+}
+
+TEST(transformations, view_transform_for_default_orientation)
+{
+    const auto transform = view_transform(Point4{0.f, 0.f, 0.f, 1.f},
+                                          Point4{0.f, 0.f, -1.f, 1.f},
+                                          Vec4{0.f, 1.f, 0.f, 0.f});
+    ASSERT_EQ(transform, matrix::identity4);
+}
+
+TEST(transformations, view_transform_looking_in_positive_z_direction)
+{
+    const auto transform = view_transform(Point4{0.f, 0.f, 0.f, 1.f},
+                                          Point4{0.f, 0.f, 1.f, 1.f},
+                                          Vec4{0.f, 1.f, 0.f, 0.f});
+    ASSERT_EQ(transform, scaling(-1.f, 1.f, -1.f));
+}
+
+TEST(transformations, view_transform_moves_the_world)
+{
+    const auto transform = view_transform(Point4{0.f, 0.f, 8.f, 1.f},
+                                          Point4{0.f, 0.f, 0.f, 1.f},
+                                          Vec4{0.f, 1.f, 0.f, 0.f});
+    ASSERT_EQ(transform, translation(0.f, 0.f, -8.f));
+}
+
+TEST(transformations, arbitrary_view_transform)
+{
+    const auto transform = view_transform(Point4{1.f, 3.f, 2.f, 1.f},
+                                          Point4{4.f, -2.f, 8.f, 1.f},
+                                          Vec4{1.f, 1.f, 0.f, 0.f});
+    const Mat4 expected{-0.50709f, 0.50709f, 0.67612f, -2.36643f,
+                        0.76772f, 0.60609f, 0.12122f, -2.82843f,
+                        -0.35857f, 0.59761f, -0.71714f, 0.f,
+                        0.f, 0.f, 0.f, 1.f};
+    for (std::size_t row{0}; row < 4; ++row) {
+        for (std::size_t column{0}; column < 4; ++column) {
+            ASSERT_NEAR(transform.at(row, column), expected.at(row, column), 1e-4f);
+        }
+    }
+}
@@ -109,3 +109,16 @@ TEST(vector, addition_of_two_vectors_should_produce_a_vector)
     ASSERT_EQ(v1+v2, expected_result);
     ASSERT_EQ(v2+v1, expected_result);
 }
+
+TEST(vector, unchecked_access_should_match_checked_access)
+{
+    Vec4 v{1.f, 2.f, 3.f, 4.f};
+    ASSERT_EQ(v[2], v.at(2));
+    ASSERT_EQ(v.get<3>(), 4.f);
+    ASSERT_EQ(v.data()[1], 2.f);
+    v[0] = 5.f;
+    v.get<1>() = 6.f;
+    ASSERT_EQ(v.at(0), 5.f);
+    ASSERT_EQ(v.at(1), 6.f);
+    ASSERT_THROW(v.at(4), std::runtime_error);
+}